@@ -3,11 +3,17 @@
 
 #include <string>		// for std::string
 #include <map>			// for std::map
+#include <chrono>		// for std::chrono::steady_clock
+#include <memory>		// for std::unique_ptr
 #include <common/all.h> // for FieldInfo, FieldCoords
+#include <common/field_observation.h> // for FieldObservation
 
 // amount of all boats on the filed (1 x size4 + 2 x size3 + 3 x size2 + 4 x size1)
 #define ALL_BOATS_COUNT 10 
 
+// Short result to apply by algo after each try
+enum ShotResult { SR_MISSED, SR_HARMED, SR_KILLED };
+
 // Generic data of any algorithm, will be maintained by engine and avaliable as const object
 struct DSBAlgoGenricData {
 	unsigned int _step_number;	// turn number, starting from 1
@@ -15,6 +21,9 @@ struct DSBAlgoGenricData {
 	// Note - standard field does not mark margin of already killed ships (they will be still 'UNKNOWN')
 	FieldInfo _field;
 
+	// The same shot results as bit sets in both orientations (margin of killed boats is not marked either)
+	FieldObservation _obs;
+
 	unsigned int _killed_boats;				// amount of killed boats of all sizes
 	unsigned int _killed_boats_of_size[4];	// amount of killed boats per each size
 
@@ -24,6 +33,27 @@ struct DSBAlgoGenricData {
 	{
 		memset(&_killed_boats_of_size[0], 0, sizeof(_killed_boats_of_size));
 	}
+
+	// Update by the result of the shot at cell; killed_boat is all cells of the boat (used only for SR_KILLED)
+	void apply_shot_result(CellIdx cell, ShotResult res, const CellBitboard& killed_boat = CellBitboard())
+	{
+		switch (res) {
+			case SR_MISSED:
+				_field.set(cell, FPI_MISSED);
+				_obs.set_missed(cell);
+				break;
+			case SR_HARMED:
+				_field.set(cell, FPI_HARMED);
+				_obs.set_harmed(cell);
+				break;
+			case SR_KILLED:
+				_field.set(cell, FPI_KILLED);
+				_obs.set_killed(cell, killed_boat);
+				_killed_boats++;
+				_killed_boats_of_size[killed_boat.count()-1]++;
+				break;
+		}
+	}
 };
 
 // Algo processing result:
@@ -36,9 +66,6 @@ struct DSBAlgoGenricData {
 // 'ASR_NO_GUESS' is used by primitive stage of algo to report that this algorithm cannot guess any location of the boat
 enum AlgoStepRes { ASR_OK, ASR_FAILURE, ASR_INTERNAL_ERROR, ASR_NO_GUESS, ASR_WON };
 
-// Short result to apply by algo after each try
-enum ShotResult { SR_MISSED, SR_HARMED, SR_KILLED };
-
 enum ShotHint { SH_COLORED = 1, SH_NUMBERED = 2, SH_COLORED_AND_NUMBERED = 3 };
 struct ShotHintData {
 	int hint_flags; /* filled by ShotHint values */
@@ -48,6 +75,46 @@ struct ShotHintData {
 
 typedef std::map<FieldCoords,ShotHintData> ShotHints;
 
+// Budget of one decision set by the engine. Algos with heavy stages (sampling, counting, search) stop
+// at the deadline or after the iterations and return the best shot found so far; cheap algos ignore it.
+// Iterations are counted in the algo's own units (sampled fleets, search nodes, ...).
+struct DecisionBudget {
+	typedef std::chrono::steady_clock::time_point TimePoint;
+
+	bool				_has_deadline;
+	TimePoint			_deadline;
+	unsigned long long	_iterations;	// 0 means no limit
+
+	DecisionBudget()
+		: _has_deadline(false)
+		, _iterations(0)
+	{ }
+
+	// The earlier one of the budget's deadline and the algo's own one (NULL if neither is set)
+	const TimePoint* get_deadline(const TimePoint* deadline) const
+	{
+		if (_has_deadline && (deadline == NULL || _deadline < *deadline)) {
+			return &_deadline;
+		}
+		return deadline;
+	}
+
+	// The deadline is set and passed already: heavy stages bail out, so the cheap ones answer in time
+	bool is_expired() const
+	{
+		return _has_deadline && std::chrono::steady_clock::now() >= _deadline;
+	}
+
+	// The smaller one of the budget's iterations and the algo's own limit (0 means no limit)
+	unsigned long long get_iterations(unsigned long long iterations) const
+	{
+		if (_iterations > 0 && (iterations == 0 || _iterations < iterations)) {
+			return _iterations;
+		}
+		return iterations;
+	}
+};
+
 // Interface of sea battle algorithm
 class DSBAlgoApi {
 public:
@@ -70,11 +137,43 @@ public:
 
 	virtual DSBAlgoApi* clone(const DSBAlgoGenricData& gdata) const = 0;
 
-	virtual AlgoStepRes get_next_shot(FieldCoords& coords, ShotHints* shot_hints) = 0;
-	virtual AlgoStepRes get_next_shot_or_bail(FieldCoords& coords, ShotHints* shot_hints) = 0;
+	virtual AlgoStepRes get_next_shot(FieldCoords& coords, ShotHints* shot_hints, const DecisionBudget& budget) = 0;
 
 	virtual AlgoStepRes apply_shot_result(const FieldCoords& coords, ShotResult res) = 0;
 
+	// Salvo turn: up to count distinct shots chosen before any of their results is known (the engine applies
+	// the results one by one after the turn). The default adapter loops over get_next_shot(): the algo makes
+	// the first shot, its clone makes the rest assuming that the previous shots of the turn have missed.
+	// The clone is made on the heap each turn and starts without the learned state of the algo, so the
+	// turns of such algos allocate (pipeline algos override it with a fork by value).
+	virtual AlgoStepRes get_next_shots(unsigned int count, FieldCoords* coords, unsigned int& shots_count,
+		const DecisionBudget& budget)
+	{
+		shots_count = 0;
+		AlgoStepRes res = get_next_shot(coords[0], NULL, budget);
+		if (res != ASR_OK) {
+			return res;
+		}
+		shots_count = 1;
+		if (count == 1) {
+			return ASR_OK;
+		}
+
+		DSBAlgoGenricData gdata(_gdata);
+		std::unique_ptr<DSBAlgoApi> fork(clone(gdata));
+		while (shots_count < count) {
+			const FieldCoords& prev = coords[shots_count-1];
+			gdata.apply_shot_result(CellIdx(prev), SR_MISSED);
+			fork->apply_shot_result(prev, SR_MISSED);
+			gdata._step_number++;
+			if (gdata._obs._unknown.empty() || fork->get_next_shot(coords[shots_count], NULL, budget) != ASR_OK) {
+				break; // no more cells to shoot, the turn is shorter
+			}
+			shots_count++;
+		}
+		return ASR_OK;
+	}
+
 protected:
 	const DSBAlgoGenricData& _gdata;
 };
@@ -1,28 +1,29 @@
 #include "basic_algo.h"
 
-AlgoStepRes BasicAlgo::get_next_shot_or_bail(FieldCoords& coords, ShotHints* shot_hints)
+void fill_probability_hints(const double* probabilities, const CellBitboard& cells, const FewCells& chosen,
+	ShotHints& shot_hints)
 {
-	if (!_field_m.get_first_unknown(coords)) {
-		return ASR_FAILURE;
-	}
-	return ASR_OK;
-}
+	for (CellBitboard rest = cells; !rest.empty(); ) {
+		const CellIdx cell = rest.first();
+		rest.reset(cell);
+		if (probabilities[cell.index()] <= 0) continue;
 
-AlgoStepRes BasicAlgo::get_next_shot(FieldCoords& coords, ShotHints* shot_hints)
-{
-	// in case previous shot has harmed some ship we need to finish it
-	if ( _field_m.has_harmed_boat()) {
-		return _field_m.get_next_short_for_harmed_boat(coords, shot_hints);
+		ShotHintData data = { SH_NUMBERED, static_cast<int>(probabilities[cell.index()]*100), 0 };
+		for (auto it=chosen.begin(); it != chosen.end(); ++it) {
+			if (*it == cell) {
+				data.hint_flags = SH_COLORED_AND_NUMBERED;
+				data.hint_color = 1;
+				break;
+			}
+		}
+		shot_hints[cell.coords()] = data;
 	}
-	return get_next_shot_or_bail(coords, shot_hints);
 }
 
-AlgoStepRes BasicAlgo::apply_shot_result(const FieldCoords& coords, ShotResult res)
+AlgoStepRes FirstUnknownStage::get_next_shot_or_bail(AlgoContext& ctx, FieldCoords& coords, ShotHints* shot_hints)
 {
-	if (res == SR_KILLED && _gdata._killed_boats == ALL_BOATS_COUNT) {
-		return ASR_WON;
+	if (!ctx._field_m.get_first_unknown(ctx._gdata._obs, coords)) {
+		return ASR_FAILURE;
 	}
-
-	return _field_m.apply_shot_result(coords, res);
+	return ASR_OK;
 }
-
@@ -1,27 +1,87 @@
 #ifndef __BASIC_ALGO_H__
 #define __BASIC_ALGO_H__
 
+#include <type_traits>	// for std::is_trivially_copyable
+
 #include <algo/api/dsb_algo_api.h>
 #include <algo/common/margined_field.h>
 
-class BasicAlgo 
-	: public DSBAlgoApi
-{
-public:
-	BasicAlgo(const DSBAlgoGenricData& gdata)
-		: DSBAlgoApi(gdata)
+// State shared by all stages of the algo pipeline: generic data maintained by engine,
+// the margin of killed boats maintained by the pipeline from shot results and the budget of the current decision
+struct AlgoContext {
+	AlgoContext(const DSBAlgoGenricData& gdata)
+		: _gdata(gdata)
+	{ }
+
+	AlgoContext(const DSBAlgoGenricData& gdata, const MarginedField& field_m)
+		: _gdata(gdata)
+		, _field_m(field_m)
+	{ }
+
+	const DSBAlgoGenricData& _gdata;
+	MarginedField _field_m;
+	DecisionBudget _budget;
+};
+
+// Value copy of the state seen by the pipeline: the generic data and the margin of killed boats.
+// It is plain bitboards (no heap), so lookahead forks it for free to play hypothetical shots
+// and runs stages on the fork via get_context().
+struct AlgoSnapshot {
+	explicit AlgoSnapshot(const AlgoContext& ctx)
+		: _gdata(ctx._gdata)
+		, _field_m(ctx._field_m)
 	{ }
 
-	// Basic algo defines the very primitive shooting algorithm and standard handling of margined field.
-	// get_next_shot_or_bail() might be used by derived classes if more complicated logic
-	// is not possible (for example eclipsed algorithm cannot find any eclipse any more OR field-mask algorithm has already shooted via whole mask).
-	// apply_shot_result() can be re-defined if more actions are needed by specific algo
+	// The context is valid while the snapshot is alive, its decision budget is unlimited
+	AlgoContext get_context() const
+	{
+		return AlgoContext(_gdata, _field_m);
+	}
+
+	// Hypothetical shot result, the same way as the engine and the pipeline apply the real one
+	AlgoStepRes apply_shot_result(CellIdx cell, ShotResult res, const CellBitboard& killed_boat = CellBitboard())
+	{
+		_gdata.apply_shot_result(cell, res, killed_boat);
+		_gdata._step_number++;
+		return _field_m.apply_shot_result(_gdata._obs, cell.coords(), res);
+	}
 
-	virtual AlgoStepRes get_next_shot_or_bail(FieldCoords& coords, ShotHints* shot_hints) override;
-	virtual AlgoStepRes get_next_shot(FieldCoords& coords, ShotHints* shot_hints) override;
-	virtual AlgoStepRes apply_shot_result(const FieldCoords& coords, ShotResult res) override;
-protected:
+	DSBAlgoGenricData _gdata;
 	MarginedField _field_m;
 };
 
+static_assert(std::is_trivially_copyable<AlgoSnapshot>::value, "AlgoSnapshot must be copied as plain memory");
+
+// Algo stage is a plain (non-virtual) class which is composed into the pipeline at compile time:
+//	AlgoStepRes get_next_shot_or_bail(AlgoContext& ctx, FieldCoords& coords, ShotHints* shot_hints);
+// Stage returns ASR_NO_GUESS if its logic cannot guess any location and the next stage of the pipeline is tried.
+// Stages are default-constructible, each game (algo clone) gets its own copy of the stages.
+
+// Values of cells closer than that are the same choice
+#define SAME_CHOICE_EPSILON 1e-9
+
+// Hints of the stage which chooses by the probability of each cell: cells with a positive probability
+// are numbered by it in percents, the chosen cells are colored
+void fill_probability_hints(const double* probabilities, const CellBitboard& cells, const FewCells& chosen,
+	ShotHints& shot_hints);
+
+// Finish the boat harmed by previous shots
+class TargetHarmedStage {
+public:
+	AlgoStepRes get_next_shot_or_bail(AlgoContext& ctx, FieldCoords& coords, ShotHints* shot_hints)
+	{
+		if (!ctx._field_m.has_harmed_boat(ctx._gdata._obs)) {
+			return ASR_NO_GUESS;
+		}
+		return ctx._field_m.get_next_short_for_harmed_boat(ctx._gdata._obs, coords, shot_hints);
+	}
+};
+
+// The very primitive shooting stage - the backup plan for any algo
+// (for example eclipsed algorithm cannot find any eclipse any more OR field-mask algorithm has already shooted via whole mask)
+class FirstUnknownStage {
+public:
+	AlgoStepRes get_next_shot_or_bail(AlgoContext& ctx, FieldCoords& coords, ShotHints* shot_hints);
+};
+
 #endif // __BASIC_ALGO_H__
@@ -2,149 +2,108 @@
 
 #include <cstdlib>	// for random()
 
+FieldPosInfoMargined MarginedField::get(const FieldObservation& obs, const FieldCoords& coords) const
+{
+	CellIdx cell(coords);
+	if (_margin.test(cell)) return FPIM_MARGIN;
+	if (obs._unknown.test(cell)) return FPIM_UNKNOWN;
+	if (obs._missed.test(cell)) return FPIM_MISSED;
+	if (obs._harmed.test(cell)) return FPIM_HARMED;
+	return FPIM_KILLED;
+}
+
 // Get the first unknown cell (for backup plan)
-bool MarginedField::get_first_unknown(FieldCoords& coords) const
+bool MarginedField::get_first_unknown(const FieldObservation& obs, FieldCoords& coords) const
 {
-	for (int y=0; y<FIELD_SIZE; ++y) {
-		for (int x=0; x<FIELD_SIZE; ++x) {
-			if (_field_m.get(x, y) == FPIM_UNKNOWN) {
-				coords = FieldCoords(x, y);
-				return true;
-			}
-		}
+	CellIdx cell = get_unknown(obs).first();
+	if (cell.is_none()) {
+		return false;
 	}
-	return false;
+	coords = cell.coords();
+	return true;
 }
 
-// check if the coords are in range and cell is still unknown
-bool MarginedField::is_good_for_shot(const FieldCoords coords,
-	signed int dx, signed int dy, FieldCoords& dst) const
+// Harmed cells of one boat: boats do not touch, so the harmed cells of the boat are connected only to each other
+// (several boats can be harmed at once in salvo mode)
+static CellBitboard get_first_harmed_boat(const CellBitboard& all_harmed)
 {
-	signed int x = coords._x + dx;
-	signed int y = coords._y + dy;
-	if (!_field_m.in_range(x, y)) return false;
-
-	dst = FieldCoords((unsigned int) x, (unsigned int) y);
-	return (_field_m.get(dst) == FPIM_UNKNOWN);
+	CellBitboard harmed;
+	harmed.set(all_harmed.first());
+	for (unsigned int i=1; i<4; ++i) { // the longest boat has 4 cells
+		harmed |= (get_h_neighbours(harmed) | get_v_neighbours(harmed)) & all_harmed;
+	}
+	return harmed;
 }
 
-AlgoStepRes MarginedField::get_next_shorts_for_harmed_boat(FieldCoords& coords, FewFieldCoords& res) const
+CellBitboard MarginedField::get_next_shots_for_harmed_boat(const FieldObservation& obs) const
 {
 	// Must be called only after harming the boat (but not killing it completely)
-	assert(_harm_counter>0);
+	assert(!obs._harmed.empty());
+	const CellBitboard harmed = get_first_harmed_boat(obs._harmed);
 
-	FieldCoords dst;
-
-	if (_harm_counter == 1) {
+	const CellBitboard unknown = get_unknown(obs);
+	if (harmed.count() == 1) {
 		// the 1st harm, we have 4 cells to guess in general
-		if (is_good_for_shot(_harmed_boat_head, -1, 0, dst)) res.push_back(dst);
-		if (is_good_for_shot(_harmed_boat_head, 1, 0, dst)) res.push_back(dst);
-		if (is_good_for_shot(_harmed_boat_head, 0, -1, dst)) res.push_back(dst);
-		if (is_good_for_shot(_harmed_boat_head, 0, 1, dst)) res.push_back(dst);
-	} else {
-		// well, now we do see direction of the ship, we have only two cells to guess
-		CoordsSeq boat_part(_harmed_boat_head, _harmed_boat_tail);
-		if (boat_part.is_x_seq()) {
-			FieldCoords head = boat_part.cur();
-			if (is_good_for_shot(head, -1, 0, dst)) res.push_back(dst);
-			FieldCoords tail = boat_part.tail();
-			if (is_good_for_shot(tail, 1, 0, dst)) res.push_back(dst);
-		} else {
-			FieldCoords head = boat_part.cur();
-			if (is_good_for_shot(head, 0, -1, dst)) res.push_back(dst);
-			FieldCoords tail = boat_part.tail();
-			if (is_good_for_shot(tail, 0, 1, dst)) res.push_back(dst);
-		}
+		return (get_h_neighbours(harmed) | get_v_neighbours(harmed)) & unknown;
 	}
 
-	if (res.size() == 0) return ASR_FAILURE;
-	return ASR_OK;
+	// well, now we do see direction of the ship (harmed cells have horizontal neighbours or vertical ones),
+	// we have only two cells to guess at the ends of the harmed part
+	CellBitboard h_neighbours = get_h_neighbours(harmed);
+	if (!(h_neighbours & harmed).empty()) {
+		return h_neighbours & unknown;
+	}
+	return get_v_neighbours(harmed) & unknown;
 }
 
 // Randomly choose any suitable short when the boat is harmed
-AlgoStepRes MarginedField::get_next_short_for_harmed_boat(FieldCoords& coords, ShotHints* shot_hints) const
+AlgoStepRes MarginedField::get_next_short_for_harmed_boat(const FieldObservation& obs, FieldCoords& coords, ShotHints* shot_hints) const
 {
-	FewFieldCoords ffc;
-	AlgoStepRes res = get_next_shorts_for_harmed_boat(coords, ffc);
-	if (res != ASR_OK) return res;
+	CellBitboard cells = get_next_shots_for_harmed_boat(obs);
+	unsigned int count = cells.count();
+	if (count == 0) return ASR_FAILURE;
 
-	assert(ffc.size() > 0);
-	coords = ffc[random() % ffc.size()];
+	// candidates are taken in cell index order (not in the order they were found), so the shot chosen
+	// for the given seed differs from the versions before the bitboard field
+	coords = cells.select(random() % count).coords();
 
 	if (shot_hints != NULL) {
 		ShotHintData hint_data = {SH_COLORED, /* hint_number = */ 0, /* hint_color = */ 1};
-		for (auto hint_coords : ffc) (*shot_hints)[hint_coords] = hint_data;
-	}
-	
-	return ASR_OK;
-}
-
-// When bot is completely killed, all margin cells are marked appropriately + all harmed cels are re-marked as 'killed'
-void MarginedField::mark_killed_boat()
-{
-	CoordsSeq boat(_harmed_boat_head, _harmed_boat_tail);
-
-	FieldCoords c1;
-	FieldCoords c2;
-	boat.get_margin(c1, c2); // get corners of the margin
-
-	// mark margin area on the field
-	for (unsigned int x = c1._x; x <= c2._x; ++x) {
-		for (unsigned int y = c1._y; y <= c2._y; ++y) {
-			_field_m._info[x][y] = FPIM_MARGIN;
+		for (CellIdx cell(0); cell.index() < FIELD_CELLS; ++cell._idx) {
+			if (cells.test(cell)) (*shot_hints)[cell.coords()] = hint_data;
 		}
 	}
-
-	// mark killed boat itself on the field
-	boat.mark_a_boat(_field_m, FPIM_KILLED);
-}
-
-AlgoStepRes MarginedField::update_harmed_boat(const FieldCoords& coords)
-{
-	if (coords.is_hv_adjacent(_harmed_boat_head)) {
-		_harmed_boat_head = coords;
-	} else if (coords.is_hv_adjacent(_harmed_boat_tail)) {
-		_harmed_boat_tail = coords;
-	} else {
-		return ASR_INTERNAL_ERROR;
-	}
+	
 	return ASR_OK;
 }
 
-AlgoStepRes MarginedField::apply_shot_result(const FieldCoords& coords, ShotResult res)
+AlgoStepRes MarginedField::apply_shot_result(const FieldObservation& obs, const FieldCoords& coords, ShotResult res)
 {
 	// Assume good behaviour for algorithm:
 	// 1. No shooting the same point twice (MISSES/HARMED/KILLED)
-	// 2. No shooting at prohibited locations (MARGIN)
-	assert(_field_m._info[coords._x][coords._y] == FPIM_UNKNOWN);
+	// 2. No shooting at prohibited locations (MARGIN), except for salvo shots chosen before the boat was killed
+	CellIdx cell(coords);
+	assert(res == SR_MISSED || !_margin.test(cell));
 
-	AlgoStepRes ret = ASR_INTERNAL_ERROR;
-	if (res == SR_MISSED) {
-		_field_m._info[coords._x][coords._y] = FPIM_MISSED;
-		return ASR_OK;
-	}
-
-	// either SR_HARMED or SR_KILLED
-	if (_harm_counter == 0) {
-		_harmed_boat_head = _harmed_boat_tail = coords;	
-	} else {
-		// 2nd or 3rd harm of the big boat - update coords of tail/head
-		if ((ret = update_harmed_boat(coords)) != ASR_OK) {
-			return ret;
-		}
-	}
 	switch (res) {
-		case SR_HARMED:
-			_harm_counter++;
-			_field_m._info[coords._x][coords._y] = FPIM_HARMED;
+		case SR_MISSED:
 			return ASR_OK;
+		case SR_HARMED: {
+			// boats are straight and do not touch, so no harmed cell can be diagonal to the cell
+			// (the harm either continues the harmed boat or starts another one in salvo mode)
+			CellBitboard shot;
+			shot.set(cell);
+			const CellBitboard diagonal = dilate8(shot).and_not(get_h_neighbours(shot) | get_v_neighbours(shot) | shot);
+			if (!(diagonal & obs._harmed).empty()) {
+				return ASR_INTERNAL_ERROR;
+			}
+			return ASR_OK;
+		}
 		case SR_KILLED:
-			_harm_counter = 0; // reset harming flow for case it was harmed before
-			mark_killed_boat();
+			update_margin(obs);
 			return ASR_OK;
 		default:
 			break;
 	}
-	return ret;
+	return ASR_INTERNAL_ERROR;
 }
-
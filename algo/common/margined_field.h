@@ -1,10 +1,11 @@
 #ifndef __MARGINED_FILED_H__
 #define __MARGINED_FILED_H__ 
 
-#include <deque>
 #include <cstdint>
 #include <common/coords.h>	// for FieldCoords
 #include <common/field.h>	// for FieldInfoTpl, values of FieldPosInfo
+#include <common/cell_bitboard.h>	// for CellBitboard
+#include <common/fixed_vector.h>	// for FixedVector
 
 #include <algo/api/dsb_algo_api.h>	// for AlgoStepRes
 
@@ -12,38 +13,43 @@
 // where placement of ships is not possible due mandatory margin between ships
 enum FieldPosInfoMargined {FPIM_UNKNOWN = FPI_UNKNOWN, FPIM_MISSED = FPI_MISSED, FPIM_HARMED = FPI_HARMED, FPIM_KILLED = FPI_KILLED, FPIM_MARGIN};
 
-typedef std::deque<FieldCoords> FewFieldCoords;
+typedef FixedVector<CellIdx, FIELD_CELLS> FewCells;
 
+// Field of the algo: the shot results are taken from the observation maintained by the engine (DSBAlgoGenricData::_obs),
+// the algo itself keeps only the margin of killed boats. Marking of killed boats and looking for cells to shoot
+// are done by bitwise operations over the whole field.
 class MarginedField
 {
 public:
-	MarginedField()
-		: _harm_counter(0)
-	{ }
+	bool has_harmed_boat(const FieldObservation& obs) const
+	{
+		return !obs._harmed.empty();
+	}
 
-	bool has_harmed_boat() const
+	// Cells where boats can be: not shot yet and not in the margin of killed boats
+	CellBitboard get_unknown(const FieldObservation& obs) const
 	{
-		return (_harm_counter > 0);
+		return obs._unknown.and_not(_margin);
 	}
 
-	bool get_first_unknown(FieldCoords& coords) const;
-	AlgoStepRes get_next_short_for_harmed_boat(FieldCoords& coords, ShotHints* shot_hints) const;
-	
-	AlgoStepRes apply_shot_result(const FieldCoords& coords, ShotResult res);
+	FieldPosInfoMargined get(const FieldObservation& obs, const FieldCoords& coords) const;
+
+	bool get_first_unknown(const FieldObservation& obs, FieldCoords& coords) const;
+	AlgoStepRes get_next_short_for_harmed_boat(const FieldObservation& obs, FieldCoords& coords, ShotHints* shot_hints) const;
+
+	// Called after the engine has applied the shot result to the observation
+	AlgoStepRes apply_shot_result(const FieldObservation& obs, const FieldCoords& coords, ShotResult res);
+
+	// Margin is killed boats dilated by one cell in all directions
+	void update_margin(const FieldObservation& obs)
+	{
+		_margin = dilate8(obs._killed).and_not(obs._killed);
+	}
 
-	typedef FieldInfoTpl<FieldPosInfoMargined> FieldInfoMargined;
-	FieldInfoMargined _field_m;
+	CellBitboard _margin;	// cells around killed boats where placement of other boats is not possible
 
 private:
-	bool is_good_for_shot(const FieldCoords coords,
-		signed int dx, signed int dy, FieldCoords& dst) const;
-	AlgoStepRes get_next_shorts_for_harmed_boat(FieldCoords& coords, FewFieldCoords& res) const;
-	AlgoStepRes update_harmed_boat(const FieldCoords& coords);
-	void mark_killed_boat();
-
-	unsigned int _harm_counter;
-	FieldCoords _harmed_boat_head;
-	FieldCoords _harmed_boat_tail;
+	CellBitboard get_next_shots_for_harmed_boat(const FieldObservation& obs) const;
 };
 
 #endif // __MARGINED_FILED_H__
@@ -0,0 +1,140 @@
+#ifndef __PIPELINE_ALGO_H__
+#define __PIPELINE_ALGO_H__
+
+#include <tuple>		// for std::tuple
+#include <type_traits>	// for std::enable_if
+
+#include <algo/common/basic_algo.h>
+
+// Stages stop this much before the deadline of the decision, so the rest of the pipeline answers in time
+#define PIPELINE_DEADLINE_RESERVE_US 200
+
+// Adapter of the stages pipeline to DSBAlgoApi: stages are tried one by one at each step until some stage
+// makes a guess. Stages are composed at compile time (no virtual calls inside of the pipeline), so only
+// the engine's calls are virtual. Derived is the final algo class (needed for clone()).
+template<class Derived, class... Stages>
+class PipelineAlgo
+	: public DSBAlgoApi
+{
+public:
+	PipelineAlgo(const DSBAlgoGenricData& gdata)
+		: DSBAlgoApi(gdata)
+		, _ctx(gdata)
+	{
+		_ctx._field_m.update_margin(gdata._obs); // the algo can be cloned in the middle of the game
+	}
+
+	virtual DSBAlgoApi* clone(const DSBAlgoGenricData& gdata) const override
+	{
+		return new Derived(gdata);
+	}
+
+	virtual AlgoStepRes get_next_shot(FieldCoords& coords, ShotHints* shot_hints, const DecisionBudget& budget) override
+	{
+		_ctx._budget = get_stages_budget(budget);
+		AlgoStepRes res = get_next_shot_from_stage<0>(_stages, _ctx, coords, shot_hints);
+		// Nobody can guess: either all boats must be already killed or some stage is ill-crafted
+		return (res == ASR_NO_GUESS) ? ASR_FAILURE : res;
+	}
+
+	// The same salvo turn as the default adapter, but the fork is a value copy of the state and of the stages
+	// instead of a clone: the turn does not allocate and stages keep what they have learned (the sampled fleets)
+	virtual AlgoStepRes get_next_shots(unsigned int count, FieldCoords* coords, unsigned int& shots_count,
+		const DecisionBudget& budget) override
+	{
+		shots_count = 0;
+		AlgoStepRes res = get_next_shot(coords[0], NULL, budget);
+		if (res != ASR_OK) {
+			return res;
+		}
+		shots_count = 1;
+		if (count == 1) {
+			return ASR_OK;
+		}
+
+		AlgoSnapshot snapshot(_ctx);
+		std::tuple<Stages...> stages(_stages);
+		while (shots_count < count) {
+			snapshot.apply_shot_result(CellIdx(coords[shots_count-1]), SR_MISSED);
+			if (snapshot._gdata._obs._unknown.empty()) {
+				break; // no more cells to shoot, the turn is shorter
+			}
+			AlgoContext ctx = snapshot.get_context();
+			ctx._budget = get_stages_budget(budget);
+			if (get_next_shot_from_stage<0>(stages, ctx, coords[shots_count], NULL) != ASR_OK) {
+				break;
+			}
+			shots_count++;
+		}
+		return ASR_OK;
+	}
+
+	virtual AlgoStepRes apply_shot_result(const FieldCoords& coords, ShotResult res) override
+	{
+		if (res == SR_KILLED && _gdata._killed_boats == ALL_BOATS_COUNT) {
+			return ASR_WON;
+		}
+		return _ctx._field_m.apply_shot_result(_gdata._obs, coords, res);
+	}
+
+	// Current state of the game, to be forked by lookahead
+	AlgoSnapshot get_snapshot() const
+	{
+		return AlgoSnapshot(_ctx);
+	}
+
+protected:
+	// Access to the stage for derived algos (for example, to pass custom params to the stage of a new game)
+	template<size_t I>
+	typename std::tuple_element<I, std::tuple<Stages...>>::type& get_stage()
+	{
+		return std::get<I>(_stages);
+	}
+
+private:
+	static DecisionBudget get_stages_budget(const DecisionBudget& budget)
+	{
+		DecisionBudget stages_budget(budget);
+		if (stages_budget._has_deadline) {
+			stages_budget._deadline -= std::chrono::microseconds(PIPELINE_DEADLINE_RESERVE_US);
+		}
+		return stages_budget;
+	}
+
+	template<size_t I>
+	static typename std::enable_if<I == sizeof...(Stages), AlgoStepRes>::type
+	get_next_shot_from_stage(std::tuple<Stages...>& stages, AlgoContext& ctx, FieldCoords& coords,
+		ShotHints* shot_hints)
+	{
+		return ASR_NO_GUESS;
+	}
+
+	template<size_t I>
+	static typename std::enable_if<I < sizeof...(Stages), AlgoStepRes>::type
+	get_next_shot_from_stage(std::tuple<Stages...>& stages, AlgoContext& ctx, FieldCoords& coords,
+		ShotHints* shot_hints)
+	{
+		AlgoStepRes res = std::get<I>(stages).get_next_shot_or_bail(ctx, coords, shot_hints);
+		if (res != ASR_NO_GUESS) return res;
+		return get_next_shot_from_stage<I+1>(stages, ctx, coords, shot_hints);
+	}
+
+	AlgoContext				_ctx;
+	std::tuple<Stages...>	_stages;
+};
+
+// Defines the algo class in one line, for example:
+//	DSB_PIPELINE_ALGO(MyAlgo, "my-algo", TargetHarmedStage, RandomStage, FirstUnknownStage);
+#define DSB_PIPELINE_ALGO(AlgoClass, algo_name, ...)							\
+	class AlgoClass																\
+		: public PipelineAlgo<AlgoClass, __VA_ARGS__>							\
+	{																			\
+	public:																		\
+		AlgoClass(const DSBAlgoGenricData& gdata)								\
+			: PipelineAlgo(gdata)												\
+		{ }																		\
+																				\
+		virtual std::string get_algo_name() const override { return algo_name; }	\
+	}
+
+#endif // __PIPELINE_ALGO_H__
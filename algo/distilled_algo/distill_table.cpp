@@ -0,0 +1,149 @@
+#include "distill_table.h"
+
+#include <cstdio>		// for fopen(), fread(), fwrite()
+#include <cstring>		// for memcmp(), memset()
+#include <algorithm>	// for std::lower_bound
+
+#include <common/coords.h>	// for FIELD_SIZE
+
+// File is the magic, the amount of entries and the entries themselves (native byte order)
+static const char DISTILL_MAGIC[8] = { 'D', 'S', 'B', 'D', 'I', 'S', 'T', '1' };
+
+#define DISTILL_SIZE_SHIFT 48	// the square of the largest radius has 48 cells except the center
+#define DISTILL_RADIUS_SHIFT 50
+
+// Code bits of each row of the square for each symmetry and radius, so the code of the square is an OR of its rows.
+// Bits of the code enumerate the cells of the transformed square row by row (the center is skipped).
+struct DistillRowCodes {
+	uint64_t _codes[8][DISTILL_MAX_RADIUS][DISTILL_SQUARE][1 << DISTILL_SQUARE];
+
+	DistillRowCodes()
+	{
+		memset(_codes, 0, sizeof(_codes));
+		// symmetry t: bit 0 swaps the axes, bits 1 and 2 mirror x and y
+		for (unsigned int t = 0; t < 8; ++t) {
+			for (int r = 1; r <= DISTILL_MAX_RADIUS; ++r) {
+				unsigned int bit = 0;
+				for (int dy = -r; dy <= r; ++dy) {
+					for (int dx = -r; dx <= r; ++dx) {
+						if (dx == 0 && dy == 0) continue;
+
+						int x = (t & 1) ? dy : dx;
+						int y = (t & 1) ? dx : dy;
+						if (t & 2) x = -x;
+						if (t & 4) y = -y;
+						for (unsigned int row = 0; row < (1U << DISTILL_SQUARE); ++row) {
+							if (row & (1U << (DISTILL_MAX_RADIUS + x))) {
+								_codes[t][r-1][DISTILL_MAX_RADIUS + y][row] |= 1ULL << bit;
+							}
+						}
+						++bit;
+					}
+				}
+			}
+		}
+	}
+};
+
+static const DistillRowCodes& get_row_codes()
+{
+	static const DistillRowCodes codes;
+	return codes;
+}
+
+DistillFeatures::DistillFeatures(const CellBitboard& free, unsigned int max_alive_size, CellIdx cell)
+	: _max_alive_size(max_alive_size)
+{
+	const int x = static_cast<int>(cell.x());
+	const int y = static_cast<int>(cell.y());
+	for (int dy = -DISTILL_MAX_RADIUS; dy <= DISTILL_MAX_RADIUS; ++dy) {
+		uint64_t row = 0;
+		if (y + dy >= 0 && y + dy < FIELD_SIZE) {
+			row = free.get_row(y + dy);
+			row = (x >= DISTILL_MAX_RADIUS) ? (row >> (x - DISTILL_MAX_RADIUS)) : (row << (DISTILL_MAX_RADIUS - x));
+		}
+		_rows[DISTILL_MAX_RADIUS + dy] = static_cast<uint8_t>(row & ((1U << DISTILL_SQUARE) - 1));
+	}
+}
+
+uint64_t DistillFeatures::get_key(unsigned int radius) const
+{
+	const DistillRowCodes& row_codes = get_row_codes();
+	uint64_t canonical = ~0ULL;
+	for (unsigned int t = 0; t < 8; ++t) {
+		const uint64_t (&codes)[DISTILL_SQUARE][1 << DISTILL_SQUARE] = row_codes._codes[t][radius-1];
+		uint64_t code = 0;
+		for (unsigned int y = DISTILL_MAX_RADIUS - radius; y <= DISTILL_MAX_RADIUS + radius; ++y) {
+			code |= codes[y][_rows[y]];
+		}
+		if (code < canonical) {
+			canonical = code;
+		}
+	}
+	return canonical | (static_cast<uint64_t>(_max_alive_size - 1) << DISTILL_SIZE_SHIFT) |
+		(static_cast<uint64_t>(radius) << DISTILL_RADIUS_SHIFT);
+}
+
+CellBitboard DistillTable::get_free_cells(const FieldObservation& obs)
+{
+	return obs._unknown.and_not(dilate8(obs._killed));
+}
+
+unsigned int DistillTable::get_max_alive_size(const unsigned int* killed_boats_of_size)
+{
+	for (unsigned int size = 4; size > 1; --size) {
+		if (killed_boats_of_size[size-1] < 5 - size) {
+			return size;
+		}
+	}
+	return 1;
+}
+
+bool DistillTable::save(const std::string& path, const std::vector<DistillEntry>& entries)
+{
+	FILE* f = fopen(path.c_str(), "wb");
+	if (f == NULL) {
+		return false;
+	}
+	const uint64_t count = entries.size();
+	bool is_ok = fwrite(DISTILL_MAGIC, sizeof(DISTILL_MAGIC), 1, f) == 1 &&
+		fwrite(&count, sizeof(count), 1, f) == 1 &&
+		(count == 0 || fwrite(&entries[0], sizeof(DistillEntry), count, f) == count);
+	is_ok = (fclose(f) == 0) && is_ok;
+	return is_ok;
+}
+
+bool DistillTable::load(const std::string& path)
+{
+	FILE* f = fopen(path.c_str(), "rb");
+	if (f == NULL) {
+		return false;
+	}
+	char magic[sizeof(DISTILL_MAGIC)];
+	uint64_t count = 0;
+	bool is_ok = fread(magic, sizeof(magic), 1, f) == 1 && memcmp(magic, DISTILL_MAGIC, sizeof(magic)) == 0 &&
+		fread(&count, sizeof(count), 1, f) == 1;
+	if (is_ok) {
+		_entries.resize(count);
+		is_ok = (count == 0 || fread(&_entries[0], sizeof(DistillEntry), count, f) == count);
+	}
+	fclose(f);
+
+	for (size_t i=1; is_ok && i<_entries.size(); ++i) {
+		is_ok = _entries[i-1]._key < _entries[i]._key;
+	}
+	if (!is_ok) {
+		_entries.clear();
+	}
+	return is_ok;
+}
+
+const DistillEntry* DistillTable::find(uint64_t key) const
+{
+	auto it = std::lower_bound(_entries.begin(), _entries.end(), key,
+		[](const DistillEntry& entry, uint64_t k) { return entry._key < k; });
+	if (it == _entries.end() || it->_key != key) {
+		return NULL;
+	}
+	return &*it;
+}
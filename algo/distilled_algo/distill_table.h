@@ -0,0 +1,56 @@
+#ifndef __DISTILL_TABLE_H__
+#define __DISTILL_TABLE_H__
+
+#include <cstdint>	// for uint64_t, uint32_t
+#include <string>	// for std::string
+#include <vector>	// for std::vector
+
+#include <common/cell_idx.h>			// for CellIdx
+#include <common/cell_bitboard.h>		// for CellBitboard
+#include <common/field_observation.h>	// for FieldObservation
+
+#define DISTILL_MAX_RADIUS 3	// features are taken from squares of 3x3, 5x5 and 7x7 cells
+#define DISTILL_SQUARE (2*DISTILL_MAX_RADIUS + 1)
+
+// Statistics of the teacher's choice for one feature: how many times a cell with the feature was
+// a candidate of the decision and how many times it was chosen
+struct DistillEntry {
+	uint64_t	_key;
+	uint32_t	_chosen;
+	uint32_t	_seen;
+};
+
+// The feature of the cell is the square around it (which cells can still hold boats) together with its
+// radius and the largest alive boat; the square is reduced by its 8 symmetries (the least code of all
+// rotations and reflections), so each pattern is learnt once.
+class DistillFeatures {
+public:
+	DistillFeatures(const CellBitboard& free, unsigned int max_alive_size, CellIdx cell);
+
+	// Key of the square of radius 1..DISTILL_MAX_RADIUS
+	uint64_t get_key(unsigned int radius) const;
+
+private:
+	uint8_t			_rows[DISTILL_SQUARE];	// bit dx+DISTILL_MAX_RADIUS of row dy+DISTILL_MAX_RADIUS, cells beyond the field are 0
+	unsigned int	_max_alive_size;
+};
+
+// Lookup table of the distilled policy
+class DistillTable {
+public:
+	// Cells where boats can be: not shot yet and not in the margin of killed boats
+	static CellBitboard get_free_cells(const FieldObservation& obs);
+	static unsigned int get_max_alive_size(const unsigned int* killed_boats_of_size);
+
+	// Entries are written sorted by keys
+	static bool save(const std::string& path, const std::vector<DistillEntry>& entries);
+	bool load(const std::string& path);
+
+	const DistillEntry* find(uint64_t key) const;
+	size_t get_size() const { return _entries.size(); }
+
+private:
+	std::vector<DistillEntry>	_entries;	// sorted by keys
+};
+
+#endif // __DISTILL_TABLE_H__
@@ -0,0 +1,115 @@
+#include "distilled_algo.h"
+
+#include <cstdlib>	// for random()
+
+#include <common/custom_params_parser.h>	// for CustomParamsParser
+
+AlgoStepRes DistilledStage::get_next_shot_or_bail(AlgoContext& ctx, FieldCoords& coords, ShotHints* shot_hints)
+{
+	// the teacher was distilled without harmed boats, they are finished by the previous stage
+	const FieldObservation& obs = ctx._gdata._obs;
+	if (!_table || ctx._field_m.has_harmed_boat(obs)) {
+		return ASR_NO_GUESS;
+	}
+
+	const CellBitboard free = DistillTable::get_free_cells(obs);
+	const unsigned int free_count = free.count();
+	if (free_count == 0) {
+		return ASR_NO_GUESS;
+	}
+	const unsigned int max_alive_size = DistillTable::get_max_alive_size(ctx._gdata._killed_boats_of_size);
+	const double prior = 1.0 / free_count;	// the choice rate of a feature which tells nothing
+
+	// the rate of being chosen, pulled to the prior by one virtual observation
+	double scores[FIELD_CELLS] = {};
+	bool is_known = false;
+	FewCells good_shots;
+	double best_score = -1;
+	for (CellBitboard cells = free; !cells.empty(); ) {
+		const CellIdx cell = cells.first();
+		cells.reset(cell);
+
+		const DistillFeatures features(free, max_alive_size, cell);
+		double score = prior;
+		for (unsigned int r=DISTILL_MAX_RADIUS; r>0; --r) {
+			const DistillEntry* entry = _table->find(features.get_key(r));
+			if (entry != NULL && entry->_seen >= _min_seen) {
+				score = (entry->_chosen + prior) / (entry->_seen + 1);
+				is_known = true;
+				break;
+			}
+		}
+		scores[cell.index()] = score;
+
+		if (score > best_score + SAME_CHOICE_EPSILON) {
+			best_score = score;
+			good_shots.clear();
+		}
+		if (score >= best_score - SAME_CHOICE_EPSILON) {
+			good_shots.push_back(cell);
+		}
+	}
+	if (!is_known) {
+		return ASR_NO_GUESS;
+	}
+
+	const CellIdx best = good_shots[random() % good_shots.size()];
+	if (shot_hints != NULL) {
+		// choice rate of the teacher is shown as the probability
+		FewCells chosen;
+		chosen.push_back(best);
+		fill_probability_hints(scores, free, chosen, *shot_hints);
+	}
+
+	coords = best.coords();
+	return ASR_OK;
+}
+
+DistilledAlgo::DistilledAlgo(const DSBAlgoGenricData& gdata)
+	: PipelineAlgo(gdata)
+{ }
+
+DistilledAlgo::DistilledAlgo(const DSBAlgoGenricData& gdata, const DistilledParams& params,
+	const std::shared_ptr<const DistillTable>& table)
+	: PipelineAlgo(gdata)
+	, _params(params)
+	, _table(table)
+{
+	get_stage<1>().set_table(table, params._min_seen);
+}
+
+DSBAlgoApi* DistilledAlgo::clone(const DSBAlgoGenricData& gdata) const
+{
+	return new DistilledAlgo(gdata, _params, _table);
+}
+
+bool DistilledAlgo::process_custom_params(const std::string& params)
+{
+	CustomParamsParser p(params);
+	if (p.parse_var("ds_table", _params._table_path)) {
+		std::cout << "DistilledAlgo accepted custom parameter ds_table=" << _params._table_path << std::endl;
+	}
+	if (p.parse_var("ds_min_seen", _params._min_seen)) {
+		std::cout << "DistilledAlgo accepted custom parameter ds_min_seen=" << _params._min_seen << std::endl;
+	}
+
+	std::shared_ptr<DistillTable> table(new DistillTable);
+	if (!table->load(_params._table_path)) {
+		std::cout << "DistilledAlgo cannot load the table " << _params._table_path << " (made by dsb --distill)" << std::endl;
+		return false;
+	}
+	std::cout << "DistilledAlgo loaded " << table->get_size() << " features from " << _params._table_path << std::endl;
+	_table = table;
+	get_stage<1>().set_table(_table, _params._min_seen);
+	return true;
+}
+
+std::string DistilledAlgo::get_custom_params_usage() const
+{
+	std::string usage("ds_table=<path,default=");
+	usage += _params._table_path;
+	usage += ">:ds_min_seen=<uint,default=";
+	usage += std::to_string(_params._min_seen);
+	usage += ">";
+	return usage;
+}
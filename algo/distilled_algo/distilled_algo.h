@@ -0,0 +1,63 @@
+#ifndef __DISTILLED_ALGO_H__
+#define __DISTILLED_ALGO_H__
+
+#include <memory>	// for std::shared_ptr
+
+#include <algo/common/pipeline_algo.h>
+#include <algo/random_algo/random_algo.h>
+
+#include "distill_table.h"
+
+struct DistilledParams {
+	std::string		_table_path;	// table made by dsb --distill
+	unsigned int	_min_seen;		// features seen less times are too rare to trust, a smaller square is used
+
+	DistilledParams()
+		: _table_path("distilled.tbl")
+		, _min_seen(8)
+	{ }
+};
+
+// Shoot at the cell which the teacher algo chose most often for the same surrounding. The feature of each
+// free cell is looked up from the largest square down to the smallest one, until it was seen often enough.
+class DistilledStage {
+public:
+	DistilledStage()
+		: _min_seen(0)
+	{ }
+
+	AlgoStepRes get_next_shot_or_bail(AlgoContext& ctx, FieldCoords& coords, ShotHints* shot_hints);
+
+	void set_table(const std::shared_ptr<const DistillTable>& table, unsigned int min_seen)
+	{
+		_table = table;
+		_min_seen = min_seen;
+	}
+
+private:
+	std::shared_ptr<const DistillTable>	_table;
+	unsigned int						_min_seen;
+};
+
+class DistilledAlgo
+	: public PipelineAlgo<DistilledAlgo, TargetHarmedStage, DistilledStage, RandomStage, FirstUnknownStage>
+{
+public:
+	DistilledAlgo(const DSBAlgoGenricData& gdata);
+
+	virtual std::string get_algo_name() const override { return "distilled"; }
+
+	virtual bool process_custom_params(const std::string& params) override;
+	virtual std::string get_custom_params_usage() const override;
+
+	virtual DSBAlgoApi* clone(const DSBAlgoGenricData& gdata) const override;
+
+private:
+	DistilledAlgo(const DSBAlgoGenricData& gdata, const DistilledParams& params,
+		const std::shared_ptr<const DistillTable>& table);
+
+	DistilledParams						_params;
+	std::shared_ptr<const DistillTable>	_table;	// loaded once, shared by clones of all games
+};
+
+#endif // __DISTILLED_ALGO_H__
@@ -6,56 +6,74 @@
 #include <cmath>	// for ceilf
 
 #include <common/coords.h>					// for FIELD_SIZE
-#include <common/field_bitmap.h>			// for FieldBitmap
+#include <common/eclipse_score.h>			// for get_eclipse_scores()
 
 #define DEBUG 0 // Increment for debugging
 
 constexpr PositionScore::value_type MAX_SCORE = std::numeric_limits<PositionScore::value_type>::max();
 
+static signed short get_max_score(const PositionScore& score_map)
+{
+	signed short max_score = 0;
+	for (int y=0; y < FIELD_SIZE; y++) {
+		for (int x=0; x < FIELD_SIZE; x++) {
+			if (score_map.get(x, y) > max_score) max_score = score_map.get(x, y);
+		}
+	}
+	return max_score;
+}
+
 static void
 process_horizontal_boat(const FieldBitmap& eclipse, const FieldBitmap& denied_pos,
 	unsigned int size, PositionScore& score_map, bool is_transponated)
 {
-	FieldRow boat_mask = FieldBitmap::get_boat_initial_mask(size);
-	FieldRow margin_mask = FieldBitmap::get_margin_initial_mask(size);
+	EclipseScores scores;
+	get_eclipse_scores(eclipse, denied_pos, size, scores);
 
-	for (int x=0; x < FIELD_SIZE-size+1; x++) {
-		for (int y=0; y < FIELD_SIZE; y++) {
-			if (denied_pos.is_intersected(y, boat_mask)) continue;
+	for (int y=0; y < FIELD_SIZE; y++) {
+		for (int x=0; x < FIELD_SIZE-size+1; x++) {
+			signed short score = scores._score[y][x];
+			if (score < 0) continue;
 
-			signed short score = static_cast<signed short>(eclipse.popcount3(y, margin_mask));
 			if (is_transponated) {
 				for (int i=0; i<size; ++i) {
-					score_map._info[y][x+i] += score;
+					score_map.add(y, x+i, score);
 				}
 			} else {
 				for (int i=0; i<size; ++i) {
-					score_map._info[x+i][y] += score;
+					score_map.add(x+i, y, score);
 				}
 			}
 		}
-
-		boat_mask = boat_mask << 1;
-		margin_mask = margin_mask << 1;
 	}
 }
 
-void EclipsedAlgo::get_score4boat(PositionScore& score_map, unsigned int size)
+// eclipse is boat cells with the cells around them (and the field border), denied positions are eclipse and missed cells
+static void
+build_eclipse(FieldBitmap& eclipse, FieldBitmap& denied_pos, const CellBitboard& boats, const CellBitboard& missed)
 {
-	// Step 1 - process normal fields and horizontal boats
-	FieldBitmap eclipse;
+	denied_pos.get_dilated8(FieldBitmap(boats));
+
 	eclipse.set_border();
-	eclipse.add_eclipse(_gdata._field, /* is_set_missed = */ false);
-	FieldBitmap denied_pos;
-	denied_pos.add_eclipse(_gdata._field, /* is_set_missed = */ true);
+	eclipse |= denied_pos;
+
+	denied_pos |= FieldBitmap(missed);
+}
+
+EclipsedStage::EclipseMaps::EclipseMaps(const FieldObservation& obs)
+{
+	build_eclipse(_eclipse, _denied_pos, obs._harmed | obs._killed, obs._missed);
+	build_eclipse(_eclipse_t, _denied_pos_t, obs._harmed_t | obs._killed_t, obs._missed_t);
 
 #if DEBUG>1
-	//eclipse.dump();
+	//_eclipse.dump();
 #endif
+}
 
-	FieldBitmap field_bmp(_gdata._field, /* is_transponate = */ false);
-
-	process_horizontal_boat(eclipse, denied_pos, size, score_map, /* is_transponated = */ false);
+void EclipsedStage::get_score4boat(const EclipseMaps& maps, PositionScore& score_map, unsigned int size)
+{
+	// Step 1 - process normal fields and horizontal boats
+	process_horizontal_boat(maps._eclipse, maps._denied_pos, size, score_map, /* is_transponated = */ false);
 
 #if DEBUG>2
 	std::cout << "Boat size = " << size << ", H score:\n";
@@ -64,13 +82,7 @@ void EclipsedAlgo::get_score4boat(PositionScore& score_map, unsigned int size)
 
 	if (size > 1) {
 		// Step 2 - process transponated fields + horizontal boats (equal to vertical boats)
-		FieldBitmap eclipse_t(/* is_init = */ false);
-		eclipse_t.get_transponated(eclipse);
-
-		FieldBitmap denied_pos_t(/* is_init = */ false);
-		denied_pos_t.get_transponated(denied_pos);
-
-		process_horizontal_boat(eclipse_t, denied_pos_t, size, score_map, /* is_transponated = */ true);
+		process_horizontal_boat(maps._eclipse_t, maps._denied_pos_t, size, score_map, /* is_transponated = */ true);
 
 #if DEBUG>2
 		std::cout << "Boat size = " << size << ", TOTAL score:\n";
@@ -79,17 +91,17 @@ void EclipsedAlgo::get_score4boat(PositionScore& score_map, unsigned int size)
 	}
 }
 
-void EclipsedAlgo::fill_shot_hints(const PositionScore& score_map, const FewFieldCoords& good_shots, ShotHints& shot_hints)
+void EclipsedStage::fill_shot_hints(const PositionScore& score_map, const FewCells& good_shots, ShotHints& shot_hints)
 {
 	for (int x = 0; x < FIELD_SIZE; ++x) {
 		for (int y=0; y<FIELD_SIZE; ++y) {
 			signed short score = score_map.get(x, y);
 			if (score > 0) {
-				FieldCoords coord(x, y);
+				CellIdx cell(x, y);
 				bool is_good = false;
 
 				for (auto it=good_shots.begin(); it != good_shots.end(); ++it) {
-					if (*it == coord) {
+					if (*it == cell) {
 						is_good = true;
 						break;
 					}
@@ -99,28 +111,29 @@ void EclipsedAlgo::fill_shot_hints(const PositionScore& score_map, const FewFiel
 					data.hint_flags = SH_COLORED_AND_NUMBERED;
 					data.hint_color = 1;
 				}
-				shot_hints[coord] = data;
+				shot_hints[cell.coords()] = data;
 			}
 		}
 	}
 }
 
-AlgoStepRes EclipsedAlgo::get_next_shot_or_bail(FieldCoords& coords, ShotHints* shot_hints)
+void EclipsedStage::get_score_map(const AlgoContext& ctx, PositionScore& score_map, signed short& min_score,
+	signed short& max_score)
 {
-	signed short max_score = 0;
-	signed short min_score = MAX_SCORE;
+	max_score = 0;
+	min_score = MAX_SCORE;
 
 	// Try to get eclipse score of boats of each size (if we still have such boats alive)
-	PositionScore score_map;
+	const EclipseMaps maps(ctx._gdata._obs);
 	for (unsigned int size = 4; size > 0; --size) {
 		const signed int total_boats_count = 5 - size;
-		const int killed_boats_count = _gdata._killed_boats_of_size[size-1];
+		const int killed_boats_count = ctx._gdata._killed_boats_of_size[size-1];
 		const signed int remained_boats = total_boats_count - killed_boats_count;
 		assert(remained_boats >= 0);
 
 		if (remained_boats > 0) {
 			PositionScore score_map_of_size_x;
-			get_score4boat(score_map_of_size_x, size);
+			get_score4boat(maps, score_map_of_size_x, size);
 
 			score_map.sum(score_map_of_size_x, /* factor = */ remained_boats, min_score, max_score);
 		}
@@ -130,31 +143,49 @@ AlgoStepRes EclipsedAlgo::get_next_shot_or_bail(FieldCoords& coords, ShotHints*
 	std::cout << "TOTAL score map:\n";
 	score_map.dump();
 #endif
+}
 
-	if (max_score > 0) {
-		FewFieldCoords good_shots;
-		float deviation = 0.02f; // allowed deviation from the best choice to be less predictible
-		// calculate threshold of the score what is good enough to shoot
-		signed int thr_score = ceilf((max_score-min_score)*(1.0f-deviation)) + min_score;
-		assert(thr_score>0);
-
-		for (int x = 0; x<FIELD_SIZE; ++x) {
-			for (int y = 0; y<FIELD_SIZE; ++y) {
-				if (score_map.get(x, y) >= thr_score) {
-					FieldCoords cur_coord(x, y);
-					good_shots.push_back(cur_coord);
-				}
+CellIdx EclipsedStage::choose_good_shot(const PositionScore& score_map, signed short min_score, signed short max_score,
+	FewCells& good_shots)
+{
+	if (max_score <= 0) {
+		return CellIdx();
+	}
+
+	float deviation = 0.02f; // allowed deviation from the best choice to be less predictible
+	// calculate threshold of the score what is good enough to shoot
+	signed int thr_score = ceilf((max_score-min_score)*(1.0f-deviation)) + min_score;
+	assert(thr_score>0);
+
+	for (int x = 0; x<FIELD_SIZE; ++x) {
+		for (int y = 0; y<FIELD_SIZE; ++y) {
+			if (score_map.get(x, y) >= thr_score) {
+				good_shots.push_back(CellIdx(x, y));
 			}
 		}
+	}
 
+	assert(good_shots.size()>0);
+	return good_shots[random() % good_shots.size()];
+}
+
+AlgoStepRes EclipsedStage::get_next_shot_or_bail(AlgoContext& ctx, FieldCoords& coords, ShotHints* shot_hints)
+{
+	PositionScore score_map;
+	signed short min_score;
+	signed short max_score;
+	get_score_map(ctx, score_map, min_score, max_score);
+
+	FewCells good_shots;
+	const CellIdx cell = choose_good_shot(score_map, min_score, max_score, good_shots);
+	if (!cell.is_none()) {
 		if (shot_hints != NULL) {
 			fill_shot_hints(score_map, good_shots, *shot_hints);
 		}
 
-		assert(good_shots.size()>0);
-		coords = good_shots[random() % good_shots.size()];
+		coords = cell.coords();
 #if DEBUG>0
-		std::cout << "Eclipsed algo got min_score=" << min_score << ", max_score=" << max_score << ", thres=" << thr_score <<
+		std::cout << "Eclipsed algo got min_score=" << min_score << ", max_score=" << max_score <<
 			", coords within 'good enough' range: " << good_shots.size() << ", chosen coord=(" << coords._x << ',' << coords._y << ")\n";
 #endif
 
@@ -168,22 +199,58 @@ AlgoStepRes EclipsedAlgo::get_next_shot_or_bail(FieldCoords& coords, ShotHints*
 	return ASR_NO_GUESS;
 }
 
-AlgoStepRes EclipsedAlgo::get_next_shot(FieldCoords& coords, ShotHints* shot_hints)
+AlgoStepRes EclipsedAlgo::get_next_shots(unsigned int count, FieldCoords* coords, unsigned int& shots_count,
+	const DecisionBudget& budget)
 {
-	// Stage1: in case previous shot has harmed some ship we need to finish it
-	if ( _field_m.has_harmed_boat()) {
-		return _field_m.get_next_short_for_harmed_boat(coords, shot_hints);
+	const AlgoSnapshot snapshot = get_snapshot();
+	const AlgoContext ctx = snapshot.get_context();
+	if (count == 1 || ctx._field_m.has_harmed_boat(_gdata._obs)) {
+		// finishing of the harmed boat depends on the result of each shot
+		return PipelineAlgo::get_next_shots(count, coords, shots_count, budget);
 	}
 
-	// Stage2: no harmed boats - try shoot via field mask
-	AlgoStepRes res = get_next_shot_or_bail(coords, shot_hints);
-	if (res != ASR_NO_GUESS) return res;
+	PositionScore score_map;
+	signed short min_score;
+	signed short max_score;
+	EclipsedStage::get_score_map(ctx, score_map, min_score, max_score);
+
+	// a hit makes the diagonal neighbours margin and the boat is finished better after the hit is known,
+	// so the neighbours of chosen cells are not shot by the same salvo while there are other good cells
+	PositionScore salvo_map(score_map);
+	CellBitboard chosen;
+	shots_count = 0;
+	while (shots_count < count) {
+		FewCells good_shots;
+		CellIdx cell = EclipsedStage::choose_good_shot(salvo_map, min_score, max_score, good_shots);
+		if (cell.is_none()) {
+			// all good cells are neighbours of chosen ones, any other cell with the score is better than nothing
+			salvo_map = score_map;
+			for (CellBitboard cells = chosen; !cells.empty(); ) {
+				const CellIdx chosen_cell = cells.first();
+				cells.reset(chosen_cell);
+				salvo_map.set(chosen_cell, 0);
+			}
+			cell = EclipsedStage::choose_good_shot(salvo_map, min_score, get_max_score(salvo_map), good_shots);
+		}
+		if (cell.is_none()) {
+			break;
+		}
 
-	// Stage3: no eclipse profit - try to find remained unknown cells randomly
-	res = RandomAlgo::get_next_shot_or_bail(coords, shot_hints);
-	if (res != ASR_NO_GUESS) return res;
+		coords[shots_count++] = cell.coords();
+		chosen.set(cell);
+		CellBitboard neighbours;
+		neighbours.set(cell);
+		for (CellBitboard cells = dilate8(neighbours); !cells.empty(); ) {
+			const CellIdx neighbour = cells.first();
+			cells.reset(neighbour);
+			salvo_map.set(neighbour, 0);
+		}
+		max_score = get_max_score(salvo_map);
+	}
 
-	// Stage4: if random cannot find unknown cell for too long, bail to base dummy algo
-	return BasicAlgo::get_next_shot_or_bail(coords, shot_hints);
+	if (shots_count == 0) {
+		// no eclipse profit any more, the backup stages do the job
+		return PipelineAlgo::get_next_shots(count, coords, shots_count, budget);
+	}
+	return ASR_OK;
 }
-
@@ -1,33 +1,52 @@
 #ifndef __ECLIPSED_ALGO_H__
 #define __ECLIPSED_ALGO_H__ 
 
+#include <algo/common/pipeline_algo.h>
 #include <algo/random_algo/random_algo.h>
+#include <common/field_bitmap.h>	// for FieldBitmap
 
-class EclipsedAlgo 
-	: public virtual RandomAlgo
+// Shoot where alive boats eclipse the most of unknown cells
+class EclipsedStage {
+public:
+	AlgoStepRes get_next_shot_or_bail(AlgoContext& ctx, FieldCoords& coords, ShotHints* shot_hints);
+
+	// Score of each cell summed over alive boats and the range of scores over the field
+	static void get_score_map(const AlgoContext& ctx, PositionScore& score_map, signed short& min_score,
+		signed short& max_score);
+
+	// Random one of the cells with the score close to the best one, none if no cell has positive score
+	static CellIdx choose_good_shot(const PositionScore& score_map, signed short min_score, signed short max_score,
+		FewCells& good_shots);
+
+private:
+	// Eclipse bitmaps of the field (built from the observation bitboards of both orientations),
+	// they do not depend on the boat size so are built once per shot
+	struct EclipseMaps {
+		FieldBitmap _eclipse;
+		FieldBitmap _denied_pos;
+		FieldBitmap _eclipse_t;
+		FieldBitmap _denied_pos_t;
+
+		EclipseMaps(const FieldObservation& obs);
+	};
+
+	static void get_score4boat(const EclipseMaps& maps, PositionScore& score_map, unsigned int size);
+	void fill_shot_hints(const PositionScore& score_map, const FewCells& good_shots, ShotHints& shot_hints);
+};
+
+class EclipsedAlgo
+	: public PipelineAlgo<EclipsedAlgo, TargetHarmedStage, EclipsedStage, RandomStage, FirstUnknownStage>
 {
 public:
 	EclipsedAlgo(const DSBAlgoGenricData& gdata)
-		: BasicAlgo(gdata)
-		, RandomAlgo(gdata)
+		: PipelineAlgo(gdata)
 	{ }
 
 	virtual std::string get_algo_name() const override { return "eclipsed"; }
 
-	virtual DSBAlgoApi* clone(const DSBAlgoGenricData& gdata) const override
-	{
-		return new EclipsedAlgo(gdata);
-	}
-
-	virtual AlgoStepRes get_next_shot_or_bail(FieldCoords& coords, ShotHints* shot_hints) override;
-	virtual AlgoStepRes get_next_shot(FieldCoords& coords, ShotHints* shot_hints) override;
-	virtual AlgoStepRes apply_shot_result(const FieldCoords& coords, ShotResult res) override
-	{
-		return RandomAlgo::apply_shot_result(coords, res);
-	}
-private:
-	void get_score4boat(PositionScore& score_map, unsigned int size);
-	void fill_shot_hints(const PositionScore& score_map, const FewFieldCoords& good_shots, ShotHints& shot_hints);
+	// Salvo of the best cells of one score map which do not touch each other
+	virtual AlgoStepRes get_next_shots(unsigned int count, FieldCoords* coords, unsigned int& shots_count,
+		const DecisionBudget& budget) override;
 };
 
 #endif // __ECLIPSED_ALGO_H__
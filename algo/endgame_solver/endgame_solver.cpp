@@ -0,0 +1,471 @@
+#include "endgame_solver.h"
+
+#include <memory>		// for std::unique_ptr
+#include <algorithm>	// for std::sort
+#include <limits>		// for std::numeric_limits
+#include <cstring>		// for memcmp(), memcpy()
+#include <iostream>		// for std::cout
+
+#include <common/fixed_vector.h>			// for FixedVector
+#include <common/custom_params_parser.h>	// for CustomParamsParser
+
+// Enough to count the fleets when few cells remain unknown
+#define ENDGAME_COUNTER_STATES (1U << 14)
+
+// Outcomes of the shot: miss, harm or kill of some boat (the killed boat is a part of the outcome)
+#define OUTCOME_MISSED 0
+#define OUTCOME_HARMED 1
+#define OUTCOME_KILLED 2
+
+// Fleets of the position with the same outcome of the shot
+struct OutcomeGroup {
+	unsigned int	_first;
+	unsigned int	_count;
+	unsigned int	_outcome;
+	double			_lower_bound;	// of the remaining shots after this outcome
+};
+
+// Outcomes of one shot: missed, harmed and kills of all boats which can contain the cell
+typedef FixedVector<OutcomeGroup, 24> OutcomeGroups;
+
+static FleetCounter& get_thread_counter()
+{
+	static thread_local FleetCounter counter(ENDGAME_COUNTER_STATES);
+	return counter;
+}
+
+// Solver of the calling thread: positions solved by any game of the thread are reused
+static EndgameSolver& get_thread_solver(const EndgameParams& params)
+{
+	static thread_local std::unique_ptr<EndgameSolver> solver;
+	if (!solver || solver->get_max_nodes() != params._max_nodes || solver->get_max_fleets() != params._max_fleets) {
+		solver.reset(new EndgameSolver(params._max_nodes, params._max_fleets));
+	}
+	return *solver;
+}
+
+// Fleets of the position enumerated by the counter
+static std::vector<CountedFleet>& get_thread_fleets()
+{
+	static thread_local std::vector<CountedFleet> fleets;
+	return fleets;
+}
+
+bool EndgameParams::parse(const std::string& params, const std::string& algo_class)
+{
+	CustomParamsParser p(params);
+	if (p.parse_var("en_max_cells", _max_cells)) {
+		std::cout << algo_class << " accepted custom parameter en_max_cells=" << _max_cells << std::endl;
+	}
+	if (p.parse_var("en_max_fleets", _max_fleets)) {
+		std::cout << algo_class << " accepted custom parameter en_max_fleets=" << _max_fleets << std::endl;
+	}
+	if (p.parse_var("en_max_nodes", _max_nodes)) {
+		std::cout << algo_class << " accepted custom parameter en_max_nodes=" << _max_nodes << std::endl;
+	}
+	if (p.parse_var("en_time_ms", _time_ms)) {
+		std::cout << algo_class << " accepted custom parameter en_time_ms=" << _time_ms << std::endl;
+	}
+
+	if (_max_fleets > MAX_ENDGAME_FLEETS) {
+		std::cout << algo_class << " needs en_max_fleets not greater than " << MAX_ENDGAME_FLEETS << std::endl;
+		return false;
+	}
+	return true;
+}
+
+std::string EndgameParams::get_usage() const
+{
+	std::string usage("en_max_cells=<uint,0 turns the endgame solver off,default=");
+	usage += std::to_string(_max_cells);
+	usage += ">:en_max_fleets=<uint,0..";
+	usage += std::to_string(MAX_ENDGAME_FLEETS);
+	usage += ",default=";
+	usage += std::to_string(_max_fleets);
+	usage += ">:en_max_nodes=<uint,default=";
+	usage += std::to_string(_max_nodes);
+	usage += ">:en_time_ms=<uint,0 means no limit,default=";
+	usage += std::to_string(_time_ms);
+	usage += ">";
+	return usage;
+}
+
+EndgameSolver::EndgameSolver(unsigned int max_nodes, unsigned int max_fleets)
+	: _max_nodes(max_nodes)
+	, _max_fleets(max_fleets)
+	, _nodes(0)
+	, _nodes_limit(max_nodes)
+	, _is_aborted(false)
+	, _deadline(NULL)
+	, _fleets(NULL)
+	, _positions_count(0)
+{
+	size_t capacity = 1024;
+	while (capacity < static_cast<size_t>(max_nodes)*4) {
+		capacity *= 2; // positions of several decisions are kept
+	}
+	_positions.resize(capacity, Position());
+	_slot_mask = static_cast<uint32_t>(capacity - 1);
+	_fleet_cells.reserve(max_fleets);
+	_order.reserve(max_fleets);
+}
+
+void EndgameSolver::make_key(const FieldObservation& obs, uint64_t* key)
+{
+	const CellBitboard* sets[3] = {&obs._missed, &obs._harmed, &obs._killed};
+	for (unsigned int s=0; s<3; ++s) {
+		for (unsigned int w=0; w<BITBOARD_WORDS; ++w) {
+			key[s*BITBOARD_WORDS + w] = sets[s]->get_window(CellIdx(w*64));
+		}
+	}
+}
+
+static uint32_t get_key_hash(const uint64_t* key)
+{
+	uint64_t hash = 0;
+	for (unsigned int i=0; i<BITBOARD_WORDS*3; ++i) {
+		hash = (hash ^ key[i]) * 0x9E3779B97F4A7C15ULL;
+	}
+	return static_cast<uint32_t>(hash >> 32);
+}
+
+static bool is_free_key(const uint64_t* key)
+{
+	for (unsigned int i=0; i<BITBOARD_WORDS*3; ++i) {
+		if (key[i] != 0) return false;
+	}
+	return true; // the position without shots is never solved
+}
+
+const EndgameSolver::Position* EndgameSolver::find_position(const uint64_t* key) const
+{
+	for (uint32_t slot = get_key_hash(key) & _slot_mask; ; slot = (slot + 1) & _slot_mask) {
+		const Position& pos = _positions[slot];
+		if (is_free_key(pos._key)) {
+			return NULL;
+		}
+		if (memcmp(pos._key, key, sizeof(pos._key)) == 0) {
+			return &pos;
+		}
+	}
+}
+
+void EndgameSolver::add_position(const uint64_t* key, double value, CellIdx best)
+{
+	if (_positions_count*2 >= _positions.size()) {
+		std::fill(_positions.begin(), _positions.end(), Position());
+		_positions_count = 0;
+	}
+	uint32_t slot = get_key_hash(key) & _slot_mask;
+	while (!is_free_key(_positions[slot]._key)) {
+		slot = (slot + 1) & _slot_mask;
+	}
+	Position& pos = _positions[slot];
+	memcpy(pos._key, key, sizeof(pos._key));
+	pos._value = value;
+	pos._best = best;
+	++_positions_count;
+}
+
+unsigned int EndgameSolver::get_outcome(unsigned int fleet, const FieldObservation& obs, CellIdx cell) const
+{
+	if (!_fleet_cells[fleet].test(cell)) {
+		return OUTCOME_MISSED;
+	}
+
+	const CountedFleet& boats = (*_fleets)[fleet];
+	for (unsigned int b=0; b<boats._count; ++b) {
+		const CellBitboard& boat = boats._boats[b];
+		if (!boat.test(cell)) continue;
+
+		CellBitboard alive = boat.and_not(obs._harmed);
+		alive.reset(cell);
+		if (!alive.empty()) {
+			return OUTCOME_HARMED;
+		}
+		// killed boats of different positions are different outcomes
+		const CellIdx head = boat.first();
+		const unsigned int size = boat.count();
+		const bool is_vertical = (size > 1) && boat.test(CellIdx(head.index() + FIELD_SIZE));
+		return OUTCOME_KILLED + (head.index()*8 + size)*2 + (is_vertical ? 1 : 0);
+	}
+	assert(false); // cells of the fleet are cells of its boats
+	return OUTCOME_MISSED;
+}
+
+// Each remaining boat cell needs a shot, and the next shot misses with the probability of the best cell to miss
+double EndgameSolver::get_lower_bound(const CellBitboard& unknown, unsigned int first, unsigned int count,
+	unsigned int remaining) const
+{
+	if (count == 1 || remaining == 0) {
+		return remaining;
+	}
+	unsigned int hits[FIELD_CELLS] = {};
+	unsigned int max_hits = 0;
+	for (unsigned int i=first; i<first+count; ++i) {
+		for (CellBitboard cells = _fleet_cells[_order[i]] & unknown; !cells.empty(); ) {
+			const CellIdx cell = cells.first();
+			cells.reset(cell);
+			if (++hits[cell.index()] > max_hits) {
+				max_hits = hits[cell.index()];
+			}
+		}
+	}
+	return remaining + 1 - static_cast<double>(max_hits) / count;
+}
+
+// Expected amount of shots after the shot at the cell, or a value not less than cutoff if it can't be better
+double EndgameSolver::evaluate_shot(const FieldObservation& obs, unsigned int first, unsigned int count, CellIdx cell,
+	unsigned int remaining, double cutoff)
+{
+	uint16_t* order = &_order[first];
+	std::sort(order, order + count, [&](uint16_t a, uint16_t b) {
+		return get_outcome(a, obs, cell) < get_outcome(b, obs, cell);
+	});
+
+	CellBitboard unknown = obs._unknown;
+	unknown.reset(cell);
+	OutcomeGroups groups;
+	double lower_bound = 0;
+	for (unsigned int i=0; i<count; ) {
+		OutcomeGroup group = { first + i, 0, get_outcome(order[i], obs, cell), 0 };
+		while (i < count && get_outcome(order[i], obs, cell) == group._outcome) {
+			++group._count;
+			++i;
+		}
+		group._lower_bound = get_lower_bound(unknown, group._first, group._count,
+			remaining - (group._outcome != OUTCOME_MISSED ? 1 : 0));
+		lower_bound += static_cast<double>(group._count) / count * group._lower_bound;
+		groups.push_back(group);
+	}
+
+	double value = 1;
+	for (auto it=groups.begin(); it != groups.end(); ++it) {
+		if (value + lower_bound >= cutoff) {
+			return value + lower_bound;
+		}
+
+		const double probability = static_cast<double>(it->_count) / count;
+		FieldObservation next(obs);
+		if (it->_outcome == OUTCOME_MISSED) {
+			next.set_missed(cell);
+		} else if (it->_outcome == OUTCOME_HARMED) {
+			next.set_harmed(cell);
+		} else {
+			const CountedFleet& boats = (*_fleets)[_order[it->_first]];
+			for (unsigned int b=0; b<boats._count; ++b) {
+				if (boats._boats[b].test(cell)) {
+					next.set_killed(cell, boats._boats[b]);
+					break;
+				}
+			}
+		}
+
+		value += probability * solve_position(next, it->_first, it->_count, NULL);
+		lower_bound -= probability * it->_lower_bound;
+		if (_is_aborted) {
+			return value;
+		}
+	}
+	return value;
+}
+
+double EndgameSolver::solve_position(const FieldObservation& obs, unsigned int first, unsigned int count, CellIdx* best)
+{
+	const CellBitboard alive = _fleet_cells[_order[first]] & obs._unknown;
+	const unsigned int remaining = alive.count(); // the same for all consistent fleets
+	if (count == 1 || remaining == 0) {
+		// no more misses: shoot the remaining cells of the only fleet
+		if (best != NULL) {
+			*best = alive.first();
+		}
+		return remaining;
+	}
+
+	uint64_t key[BITBOARD_WORDS*3];
+	make_key(obs, key);
+	const Position* pos = find_position(key);
+	if (pos != NULL) {
+		if (best != NULL) {
+			*best = pos->_best;
+		}
+		return pos->_value;
+	}
+
+	++_nodes;
+	if (_nodes > _nodes_limit ||
+		(_deadline != NULL && (_nodes % 64) == 0 && std::chrono::steady_clock::now() > *_deadline)) {
+		_is_aborted = true;
+		return 0;
+	}
+
+	// the most probable cells are tried first: their lower bound is the smallest one
+	unsigned int hits[FIELD_CELLS] = {};
+	for (unsigned int i=first; i<first+count; ++i) {
+		for (CellBitboard cells = _fleet_cells[_order[i]] & obs._unknown; !cells.empty(); ) {
+			const CellIdx cell = cells.first();
+			cells.reset(cell);
+			hits[cell.index()]++;
+		}
+	}
+	FixedVector<CellIdx, FIELD_CELLS> candidates;
+	for (CellIdx cell(0); cell.index() < FIELD_CELLS; ++cell._idx) {
+		if (hits[cell.index()] > 0) {
+			candidates.push_back(cell);
+		}
+	}
+	std::sort(candidates.begin(), candidates.end(), [&](CellIdx a, CellIdx b) {
+		return hits[a.index()] > hits[b.index()] || (hits[a.index()] == hits[b.index()] && a.index() < b.index());
+	});
+
+	double best_value = std::numeric_limits<double>::max();
+	CellIdx best_cell;
+	for (auto it=candidates.begin(); it != candidates.end(); ++it) {
+		const unsigned int cell_hits = hits[it->index()];
+		if (remaining + 1 - static_cast<double>(cell_hits) / count >= best_value) {
+			break;
+		}
+
+		const double value = evaluate_shot(obs, first, count, *it, remaining, best_value);
+		if (_is_aborted) {
+			return 0;
+		}
+		if (value < best_value) {
+			best_value = value;
+			best_cell = *it;
+		}
+		// the sure hit is never worse than any other shot
+		if (cell_hits == count) {
+			break;
+		}
+	}
+
+	add_position(key, best_value, best_cell);
+	if (best != NULL) {
+		*best = best_cell;
+	}
+	return best_value;
+}
+
+bool EndgameSolver::solve(const FieldObservation& obs, const std::vector<CountedFleet>& fleets, const TimePoint* deadline,
+	unsigned int max_nodes, CellIdx& best, double& expected_shots)
+{
+	assert(!fleets.empty() && fleets.size() <= _max_fleets);
+	_fleets = &fleets;
+	_fleet_cells.resize(fleets.size());
+	_order.resize(fleets.size());
+	for (size_t f=0; f<fleets.size(); ++f) {
+		_fleet_cells[f] = CellBitboard();
+		for (unsigned int b=0; b<fleets[f]._count; ++b) {
+			_fleet_cells[f] |= fleets[f]._boats[b];
+		}
+		_order[f] = static_cast<uint16_t>(f);
+	}
+
+	_nodes = 0;
+	_nodes_limit = (max_nodes < _max_nodes) ? max_nodes : _max_nodes;
+	_is_aborted = false;
+	_deadline = deadline;
+	expected_shots = solve_position(obs, 0, static_cast<unsigned int>(fleets.size()), &best);
+	return !_is_aborted;
+}
+
+// Fleets of 1-size boats at the cells of the mask (bit i is the cell 2*i of the first row),
+// all other cells are missed
+static bool is_solved_as(const std::vector<unsigned int>& fleet_masks, unsigned int cells_mask, double expected_shots)
+{
+	FieldObservation obs;
+	for (CellIdx cell(0); cell.index() < FIELD_CELLS; ++cell._idx) {
+		if (cell.y() != 0 || (cell.x() % 2) != 0 || (cells_mask & (1U << (cell.x() / 2))) == 0) {
+			obs.set_missed(cell);
+		}
+	}
+	std::vector<CountedFleet> fleets(fleet_masks.size());
+	for (size_t f=0; f<fleets.size(); ++f) {
+		fleets[f]._count = 0;
+		for (unsigned int i=0; i<FIELD_SIZE/2; ++i) {
+			if (fleet_masks[f] & (1U << i)) {
+				fleets[f]._boats[fleets[f]._count] = CellBitboard();
+				fleets[f]._boats[fleets[f]._count++].set(CellIdx(2*i, 0));
+			}
+		}
+	}
+
+	EndgameSolver solver(64, static_cast<unsigned int>(fleets.size()));
+	CellIdx best;
+	double value = 0;
+	return solver.solve(obs, fleets, NULL, 64, best, value) && value > expected_shots - 1e-9 &&
+		value < expected_shots + 1e-9;
+}
+
+// Hand-computed positions: one boat in 2 cells takes 1.5 shots, two boats in 3 cells take 1 + 2/3*1.5 + 1/3*2
+static bool is_solver_correct()
+{
+	return is_solved_as({1, 2}, 3, 1.5) && is_solved_as({3, 5, 6}, 7, 8.0/3);
+}
+
+void EndgameStage::set_params(const EndgameParams& params)
+{
+	_params = params;
+	if (_params._max_cells > 0) {
+		static const bool is_checked = is_solver_correct();
+		assert(is_checked);
+		(void)is_checked;
+
+		// the storage is made by the first game of the thread, not by its decisions
+		get_thread_counter();
+		get_thread_solver(_params);
+		get_thread_fleets().reserve(_params._max_fleets);
+	}
+}
+
+AlgoStepRes EndgameStage::get_next_shot_or_bail(AlgoContext& ctx, FieldCoords& coords, ShotHints* shot_hints)
+{
+	// a harmed boat is finished by the targeting stage at first
+	const DSBAlgoGenricData& gdata = ctx._gdata;
+	if (_params._max_cells == 0 || ctx._field_m.has_harmed_boat(gdata._obs)) {
+		return ASR_NO_GUESS;
+	}
+	if (ctx._budget.is_expired()) {
+		return ASR_NO_GUESS;
+	}
+	const CellBitboard unknown = ctx._field_m.get_unknown(gdata._obs);
+	if (unknown.count() > _params._max_cells) {
+		return ASR_NO_GUESS; // too early to count fleets
+	}
+
+	FleetCounter& counter = get_thread_counter();
+	FleetCounts counts;
+	if (!counter.count(gdata._obs, gdata._killed_boats_of_size, counts, ctx._budget.get_deadline(NULL)) ||
+		counts._total == 0 ||
+		counts._total > _params._max_fleets) {
+		return ASR_NO_GUESS;
+	}
+	std::vector<CountedFleet>& fleets = get_thread_fleets();
+	counter.enumerate(fleets);
+
+	EndgameSolver::TimePoint deadline;
+	const EndgameSolver::TimePoint* p_deadline = NULL;
+	if (_params._time_ms > 0) {
+		deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(_params._time_ms);
+		p_deadline = &deadline;
+	}
+	const unsigned int max_nodes = static_cast<unsigned int>(ctx._budget.get_iterations(_params._max_nodes));
+	CellIdx best;
+	double expected_shots;
+	if (!get_thread_solver(_params).solve(gdata._obs, fleets, ctx._budget.get_deadline(p_deadline), max_nodes,
+		best, expected_shots)) {
+		return ASR_NO_GUESS; // out of budget, the next stages are used
+	}
+	assert(unknown.test(best));
+
+	if (shot_hints != NULL) {
+		double probabilities[FIELD_CELLS];
+		counts.get_probabilities(probabilities);
+		FewCells chosen;
+		chosen.push_back(best);
+		fill_probability_hints(probabilities, unknown, chosen, *shot_hints);
+	}
+	coords = best.coords();
+	return ASR_OK;
+}
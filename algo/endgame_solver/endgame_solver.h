@@ -0,0 +1,97 @@
+#ifndef __ENDGAME_SOLVER_H__
+#define __ENDGAME_SOLVER_H__
+
+#include <cstdint>	// for uint16_t, uint64_t
+#include <string>	// for std::string
+#include <vector>	// for std::vector
+#include <chrono>	// for std::chrono::steady_clock
+
+#include <algo/common/basic_algo.h>
+#include <algo/exact_algo/fleet_counter.h>	// for CountedFleet
+
+// Fleets are referenced by 16 bit indices
+static const unsigned int MAX_ENDGAME_FLEETS = 0xFFFF;
+
+struct EndgameParams {
+	unsigned int _max_cells;	// switchover: unknown cells (except margin of killed boats) when fleets are counted
+	unsigned int _max_fleets;	// switchover: consistent fleets when the game is solved
+	unsigned int _max_nodes;	// budget of solved positions per decision
+	unsigned int _time_ms;		// time budget per decision, 0 means no limit
+
+	EndgameParams()
+		: _max_cells(24)
+		, _max_fleets(12)
+		, _max_nodes(5000)
+		, _time_ms(0)
+	{ }
+
+	// en_* custom params of the algos with EndgameStage, false if some value is out of range
+	bool parse(const std::string& params, const std::string& algo_class);
+	std::string get_usage() const;
+};
+
+// Expectimax over the fleets consistent with the observation (each fleet is equally likely):
+// the shot minimizing the expected amount of remaining shots. Values of positions depend only on
+// the observation, so they are memoized by its bitboards and reused by later decisions and games.
+class EndgameSolver {
+public:
+	typedef std::chrono::steady_clock::time_point TimePoint;
+
+	// max_nodes is the largest budget of solved positions per decision (the memo is sized by it),
+	// storage of up to max_fleets fleets is reserved once
+	EndgameSolver(unsigned int max_nodes, unsigned int max_fleets);
+
+	// false if the budget (the deadline or max_nodes) is exceeded before the position is solved
+	bool solve(const FieldObservation& obs, const std::vector<CountedFleet>& fleets, const TimePoint* deadline,
+		unsigned int max_nodes, CellIdx& best, double& expected_shots);
+
+	unsigned int get_max_nodes() const { return _max_nodes; }
+	unsigned int get_max_fleets() const { return _max_fleets; }
+
+private:
+	struct Position {
+		uint64_t	_key[BITBOARD_WORDS*3];	// missed, harmed and killed cells; all zeroes for a free slot
+		double		_value;
+		CellIdx		_best;
+	};
+
+	double solve_position(const FieldObservation& obs, unsigned int first, unsigned int count, CellIdx* best);
+	double get_lower_bound(const CellBitboard& unknown, unsigned int first, unsigned int count,
+		unsigned int remaining) const;
+	double evaluate_shot(const FieldObservation& obs, unsigned int first, unsigned int count, CellIdx cell,
+		unsigned int remaining, double cutoff);
+	unsigned int get_outcome(unsigned int fleet, const FieldObservation& obs, CellIdx cell) const;
+
+	static void make_key(const FieldObservation& obs, uint64_t* key);
+	const Position* find_position(const uint64_t* key) const;
+	void add_position(const uint64_t* key, double value, CellIdx best);
+
+	unsigned int		_max_nodes;
+	unsigned int		_max_fleets;
+	unsigned int		_nodes;
+	unsigned int		_nodes_limit;	// of the current decision
+	bool				_is_aborted;
+	const TimePoint*	_deadline;
+
+	const std::vector<CountedFleet>*	_fleets;
+	std::vector<CellBitboard>			_fleet_cells;	// all boat cells of each fleet
+	std::vector<uint16_t>				_order;			// fleets of positions: each position owns a range
+
+	std::vector<Position>	_positions;	// open addressing hash table
+	unsigned int			_positions_count;
+	uint32_t				_slot_mask;
+};
+
+// Solve the end of the game when few fleets are consistent with the observation (and no boat is harmed).
+// The counter, the solver and the fleets are per thread, so decisions do not allocate after the first game.
+class EndgameStage {
+public:
+	AlgoStepRes get_next_shot_or_bail(AlgoContext& ctx, FieldCoords& coords, ShotHints* shot_hints);
+
+	void set_params(const EndgameParams& params);
+
+private:
+	EndgameParams	_params;
+};
+
+#endif // __ENDGAME_SOLVER_H__
@@ -0,0 +1,104 @@
+#include "exact_algo.h"
+
+#include <memory>	// for std::unique_ptr
+#include <cstdlib>	// for random()
+
+#include <common/custom_params_parser.h>	// for CustomParamsParser
+
+FleetCounter& ExactCountStage::get_thread_counter(unsigned int max_states)
+{
+	static thread_local std::unique_ptr<FleetCounter> counter;
+	if (!counter || counter->get_max_states() != max_states) {
+		counter.reset(new FleetCounter(max_states));
+	}
+	return *counter;
+}
+
+AlgoStepRes ExactCountStage::get_next_shot_or_bail(AlgoContext& ctx, FieldCoords& coords, ShotHints* shot_hints)
+{
+	const DSBAlgoGenricData& gdata = ctx._gdata;
+	if (gdata._step_number < _retry_step || ctx._budget.is_expired()) {
+		return ASR_NO_GUESS;
+	}
+	FleetCounts counts;
+	if (!get_thread_counter(_params._max_states).count(gdata._obs, gdata._killed_boats_of_size, counts,
+		ctx._budget.get_deadline(NULL))) {
+		_retry_step = gdata._step_number + _params._retry_shots;
+		return ASR_NO_GUESS; // too early for counting (or out of the decision budget)
+	}
+
+	const CellBitboard unknown = ctx._field_m.get_unknown(gdata._obs);
+	unsigned long long max_count = 0;
+	FewCells good_shots;
+	for (CellIdx cell(0); cell.index() < FIELD_CELLS; ++cell._idx) {
+		if (!unknown.test(cell)) continue;
+
+		const unsigned long long count = counts._cells[cell.index()];
+		if (count > max_count) {
+			max_count = count;
+			good_shots.clear();
+		}
+		if (count == max_count && count > 0) {
+			good_shots.push_back(cell);
+		}
+	}
+	if (good_shots.empty()) {
+		return ASR_NO_GUESS; // no consistent fleet
+	}
+
+	if (shot_hints != NULL) {
+		double probabilities[FIELD_CELLS];
+		counts.get_probabilities(probabilities);
+		fill_probability_hints(probabilities, unknown, good_shots, *shot_hints);
+	}
+
+	coords = good_shots[random() % good_shots.size()].coords();
+	return ASR_OK;
+}
+
+ExactAlgo::ExactAlgo(const DSBAlgoGenricData& gdata)
+	: PipelineAlgo(gdata)
+{ }
+
+ExactAlgo::ExactAlgo(const DSBAlgoGenricData& gdata, const ExactParams& params, const EndgameParams& endgame_params)
+	: PipelineAlgo(gdata)
+	, _params(params)
+	, _endgame_params(endgame_params)
+{
+	get_stage<0>().set_params(endgame_params);
+	get_stage<1>().set_params(params);
+	get_stage<2>().set_params(MonteCarloParams());
+}
+
+DSBAlgoApi* ExactAlgo::clone(const DSBAlgoGenricData& gdata) const
+{
+	return new ExactAlgo(gdata, _params, _endgame_params);
+}
+
+bool ExactAlgo::process_custom_params(const std::string& params)
+{
+	CustomParamsParser p(params);
+	if (p.parse_var("ex_max_states", _params._max_states)) {
+		std::cout << "ExactAlgo accepted custom parameter ex_max_states=" << _params._max_states << std::endl;
+	}
+	if (p.parse_var("ex_retry_shots", _params._retry_shots)) {
+		std::cout << "ExactAlgo accepted custom parameter ex_retry_shots=" << _params._retry_shots << std::endl;
+	}
+
+	if (_params._max_states == 0) {
+		std::cout << "ExactAlgo needs ex_max_states to be positive" << std::endl;
+		return false;
+	}
+	return _endgame_params.parse(params, "ExactAlgo");
+}
+
+std::string ExactAlgo::get_custom_params_usage() const
+{
+	std::string usage("ex_max_states=<uint,default=");
+	usage += std::to_string(_params._max_states);
+	usage += ">:ex_retry_shots=<uint,default=";
+	usage += std::to_string(_params._retry_shots);
+	usage += ">:";
+	usage += _endgame_params.get_usage();
+	return usage;
+}
@@ -0,0 +1,66 @@
+#ifndef __EXACT_ALGO_H__
+#define __EXACT_ALGO_H__
+
+#include <algo/common/pipeline_algo.h>
+#include <algo/random_algo/random_algo.h>
+#include <algo/montecarlo_algo/montecarlo_algo.h>
+#include <algo/exact_algo/fleet_counter.h>
+#include <algo/endgame_solver/endgame_solver.h>
+
+struct ExactParams {
+	unsigned int _max_states;	// budget of the search per decision, sampling is used if it is exceeded
+	unsigned int _retry_shots;	// shots to skip counting after the budget is exceeded
+
+	ExactParams()
+		: _max_states(1U << 15)
+		, _retry_shots(3)
+	{ }
+};
+
+// Shoot at the cell with the highest hit probability counted over all fleets consistent with shot results
+class ExactCountStage {
+public:
+	ExactCountStage()
+		: _retry_step(0)
+	{ }
+
+	AlgoStepRes get_next_shot_or_bail(AlgoContext& ctx, FieldCoords& coords, ShotHints* shot_hints);
+
+	void set_params(const ExactParams& params)
+	{
+		_params = params;
+		get_thread_counter(_params._max_states); // made by the first game of the thread, not by its decisions
+	}
+
+	// Counter of the calling thread (its tables are big, so they are shared by the games of the thread)
+	static FleetCounter& get_thread_counter(unsigned int max_states);
+
+private:
+	ExactParams		_params;
+	unsigned int	_retry_step;	// the first step to try counting again
+};
+
+// Exact counting while the search fits into the budget (middle of the game), sampling before that;
+// the end of the game is solved exactly
+class ExactAlgo
+	: public PipelineAlgo<ExactAlgo, EndgameStage, ExactCountStage, MonteCarloStage, TargetHarmedStage, RandomStage,
+		FirstUnknownStage>
+{
+public:
+	ExactAlgo(const DSBAlgoGenricData& gdata);
+
+	virtual std::string get_algo_name() const override { return "exact"; }
+
+	virtual bool process_custom_params(const std::string& params) override;
+	virtual std::string get_custom_params_usage() const override;
+
+	virtual DSBAlgoApi* clone(const DSBAlgoGenricData& gdata) const override;
+
+private:
+	ExactAlgo(const DSBAlgoGenricData& gdata, const ExactParams& params, const EndgameParams& endgame_params);
+
+	ExactParams		_params;
+	EndgameParams	_endgame_params;
+};
+
+#endif // __EXACT_ALGO_H__
@@ -0,0 +1,412 @@
+#include "fleet_counter.h"
+
+#include <cassert>	// for assert()
+
+#include <common/cell_bitboard.h>	// for CellBitboard
+
+// Remaining fleet is coded as mixed radix number: digit of each size is the amount of its boats
+static constexpr unsigned int FLEET_WEIGHT[MAX_BOAT_SIZE] = {1, 5, 20, 60};
+static constexpr unsigned int FLEET_BASE[MAX_BOAT_SIZE] = {5, 4, 3, 2};
+
+// State key: blocked cells ahead of the cursor (only 42 bits can be blocked by boats), fleet and cursor
+#define KEY_MASK_BITS 42
+#define KEY_FLEET_BITS 7
+
+static inline uint64_t make_key(unsigned int cursor, unsigned int fleet, uint64_t mask)
+{
+	return mask | (static_cast<uint64_t>(fleet) << KEY_MASK_BITS) |
+		(static_cast<uint64_t>(cursor) << (KEY_MASK_BITS + KEY_FLEET_BITS));
+}
+
+// End of the list of forward states of the layer
+#define NO_LAYER_SLOT 0xFFFFFFFFU
+
+#define FLEET_CODES 120	// 5*4*3*2
+
+// Sizes of boats which are present in the fleet, as bits (bit 0 is size 1)
+class FleetSizesTable {
+public:
+	FleetSizesTable()
+	{
+		for (unsigned int fleet=0; fleet<FLEET_CODES; ++fleet) {
+			_sizes[fleet] = 0;
+			for (unsigned int size=1; size<=MAX_BOAT_SIZE; ++size) {
+				if ((fleet / FLEET_WEIGHT[size-1]) % FLEET_BASE[size-1] != 0) {
+					_sizes[fleet] |= 1U << (size-1);
+				}
+			}
+		}
+	}
+
+	unsigned int get(unsigned int fleet) const
+	{
+		return _sizes[fleet];
+	}
+
+private:
+	uint8_t _sizes[FLEET_CODES];
+};
+
+static const FleetSizesTable& get_fleet_sizes()
+{
+	static const FleetSizesTable table;
+	return table;
+}
+
+// Boat with the head at some cell, its cells and margin are relative to the head (bit 0).
+// Only the margin after the head matters: cells before it are decided already.
+struct CounterPlacement {
+	bool		_is_valid;	// the boat fits into the field
+	uint64_t	_cells;
+	uint64_t	_margin;
+};
+
+class CounterPlacementsTable {
+public:
+	CounterPlacementsTable()
+	{
+		for (unsigned int head=0; head<FIELD_CELLS; ++head) {
+			for (unsigned int size=1; size<=MAX_BOAT_SIZE; ++size) {
+				for (unsigned int v=0; v<2; ++v) {
+					init_placement(CellIdx(head), size, v != 0, _placements[head][size-1][v]);
+				}
+			}
+		}
+	}
+
+	const CounterPlacement& get(unsigned int head, unsigned int size, bool is_vertical) const
+	{
+		return _placements[head][size-1][is_vertical];
+	}
+
+private:
+	static void init_placement(CellIdx head, unsigned int size, bool is_vertical, CounterPlacement& p)
+	{
+		const BoatPlacement& boat = get_boat_placements().get(size, head.index() + (is_vertical ? FIELD_CELLS : 0));
+		p._is_valid = boat._is_valid;
+		p._cells = 0;
+		p._margin = 0;
+		if (!p._is_valid) return;
+
+		const CellBitboard margin = boat._halo.and_not(boat._cells);
+		for (unsigned int i=head.index(); i<FIELD_CELLS; ++i) {
+			if (boat._cells.test(CellIdx(i))) {
+				p._cells |= 1ULL << (i - head.index());
+			} else if (margin.test(CellIdx(i))) {
+				p._margin |= 1ULL << (i - head.index());
+			}
+		}
+		assert((p._margin >> KEY_MASK_BITS) == 0);
+	}
+
+	CounterPlacement _placements[FIELD_CELLS][MAX_BOAT_SIZE][2];
+};
+
+static const CounterPlacementsTable& get_placements()
+{
+	static const CounterPlacementsTable table;
+	return table;
+}
+
+FleetCounter::StateTable::StateTable(size_t max_size)
+{
+	size_t capacity = 1024;
+	while (capacity < max_size*2) {
+		capacity *= 2; // keep the load factor below 1/2
+	}
+	_keys.assign(capacity, 0);
+	_values.assign(capacity, 0);
+	_used.reserve(max_size + FIELD_CELLS);	// states being searched are added after the limit is checked
+	_slot_mask = static_cast<uint32_t>(capacity - 1);
+}
+
+uint32_t FleetCounter::StateTable::get_start(uint64_t key) const
+{
+	return static_cast<uint32_t>((key * 0x9E3779B97F4A7C15ULL) >> 32) & _slot_mask;
+}
+
+uint32_t FleetCounter::StateTable::find_or_add(uint64_t key, bool& is_new)
+{
+	uint32_t slot = get_start(key);
+	while (_keys[slot] != 0) {
+		if (_keys[slot] == key) {
+			is_new = false;
+			return slot;
+		}
+		slot = (slot + 1) & _slot_mask;
+	}
+	_keys[slot] = key;
+	_values[slot] = 0;
+	_used.push_back(slot);
+	is_new = true;
+	return slot;
+}
+
+bool FleetCounter::StateTable::find(uint64_t key, uint32_t& slot) const
+{
+	for (slot = get_start(key); _keys[slot] != 0; slot = (slot + 1) & _slot_mask) {
+		if (_keys[slot] == key) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void FleetCounter::StateTable::clear()
+{
+	for (uint32_t slot : _used) {
+		_keys[slot] = 0;
+	}
+	_used.clear();
+}
+
+FleetCounter::FleetCounter(size_t max_states)
+	: _max_states(max_states)
+	, _deadline(NULL)
+	, _expanded(0)
+	, _is_overflow(false)
+	, _root_cursor(0)
+	, _root_fleet(0)
+	, _root_mask(0)
+	, _states(max_states)
+	, _forward(max_states)
+	, _layer_next(_forward.get_capacity(), NO_LAYER_SLOT)
+{
+	for (unsigned int cell=0; cell<FIELD_CELLS; ++cell) {
+		_layer_heads[cell] = NO_LAYER_SLOT;
+	}
+}
+
+void FleetCounter::init(const FieldObservation& obs, const unsigned int* killed_boats_of_size)
+{
+	const CellBitboard blocked = obs._missed | dilate8(obs._killed);
+
+	unsigned int harmed_count = 0;
+	for (unsigned int cell=FIELD_CELLS; cell-- > 0; ) {
+		// cells beyond the field are blocked, so the cursor leaves the field at the end
+		const uint64_t beyond = (FIELD_CELLS - cell < 64) ? ~0ULL << (FIELD_CELLS - cell) : 0;
+		_blocked_ahead[cell] = blocked.get_window(CellIdx(cell)) | beyond;
+		_harmed_ahead[cell] = obs._harmed.get_window(CellIdx(cell));
+		harmed_count += obs._harmed.test(CellIdx(cell)) ? 1 : 0;
+		_harmed_from[cell] = harmed_count;
+	}
+
+	_root_fleet = 0;
+	for (unsigned int size=1; size<=MAX_BOAT_SIZE; ++size) {
+		assert(killed_boats_of_size[size-1] <= 5 - size);
+		_root_fleet += (5 - size - killed_boats_of_size[size-1]) * FLEET_WEIGHT[size-1];
+	}
+
+	_is_overflow = false;
+	_states.clear();
+	_forward.clear();
+	for (unsigned int cell=0; cell<FIELD_CELLS; ++cell) {
+		_layer_heads[cell] = NO_LAYER_SLOT;
+	}
+}
+
+// Move the cursor to the next cell which can be the head of a boat (or beyond the field)
+void FleetCounter::normalize(unsigned int& cursor, uint64_t& mask) const
+{
+	while (cursor < FIELD_CELLS) {
+		const uint64_t free = ~(mask | _blocked_ahead[cursor]);
+		if (free != 0) {
+			const unsigned int skip = __builtin_ctzll(free);
+			cursor += skip;
+			// cells blocked by the observation are not needed in the state key
+			mask = (cursor < FIELD_CELLS) ? (mask >> skip) & ~_blocked_ahead[cursor] : 0;
+			return;
+		}
+		cursor += 64;
+		mask = 0; // boats block less than 64 cells ahead
+	}
+}
+
+// All harmed cells from the cursor are covered by boats already
+bool FleetCounter::is_harmed_covered(unsigned int cursor, uint64_t mask) const
+{
+	if (cursor >= FIELD_CELLS) {
+		return true;
+	}
+	const uint64_t harmed = _harmed_ahead[cursor];
+	return (harmed & ~mask) == 0 && _harmed_from[cursor] == static_cast<unsigned int>(__builtin_popcountll(harmed));
+}
+
+// Calls func(next_cursor, next_fleet, next_mask, boat_cells) for each decision about the cursor cell:
+// leave it empty (boat_cells is 0) or put the head of some boat there (boat_cells are relative to the cursor).
+// The next state is normalized already.
+template<class Func>
+void FleetCounter::for_each_transition(unsigned int cursor, unsigned int fleet, uint64_t mask, Func func) const
+{
+	const CounterPlacementsTable& table = get_placements();
+	const uint64_t blocked = mask | _blocked_ahead[cursor];
+	const uint64_t harmed = _harmed_ahead[cursor];
+
+	// harmed cell can't be left empty
+	if ((harmed & 1) == 0) {
+		unsigned int next_cursor = cursor + 1;
+		uint64_t next_mask = mask >> 1;
+		normalize(next_cursor, next_mask);
+		func(next_cursor, fleet, next_mask, 0);
+	}
+
+	for (unsigned int sizes = get_fleet_sizes().get(fleet); sizes != 0; sizes &= sizes - 1) {
+		const unsigned int size = __builtin_ctz(sizes) + 1;
+
+		for (unsigned int v=0; v<2; ++v) {
+			const CounterPlacement& p = table.get(cursor, size, v != 0);
+			// the boat which is harmed completely would be killed already
+			if (!p._is_valid || (p._cells & blocked) != 0 || (p._cells & ~harmed) == 0 || (p._margin & harmed) != 0) {
+				continue;
+			}
+			unsigned int next_cursor = cursor + 1;
+			uint64_t next_mask = (mask | p._cells | p._margin) >> 1;
+			normalize(next_cursor, next_mask);
+			func(next_cursor, fleet - FLEET_WEIGHT[size-1], next_mask, p._cells);
+		}
+	}
+}
+
+unsigned long long FleetCounter::get_completions(unsigned int cursor, unsigned int fleet, uint64_t mask)
+{
+	// Harmed cells which are blocked must be covered by boats: margin of a boat never covers harmed cells
+	if (fleet == 0) {
+		return is_harmed_covered(cursor, mask) ? 1 : 0;
+	}
+	if (cursor >= FIELD_CELLS || _is_overflow) {
+		return 0;
+	}
+
+	const uint64_t key = make_key(cursor, fleet, mask);
+	uint32_t slot;
+	if (_states.find(key, slot)) {
+		return _states.value(slot);
+	}
+	if (_states.get_size() >= _max_states ||
+		(_deadline != NULL && (++_expanded % 256) == 0 && std::chrono::steady_clock::now() > *_deadline)) {
+		_is_overflow = true;
+		return 0;
+	}
+
+	unsigned long long res = 0;
+	for_each_transition(cursor, fleet, mask,
+		[&](unsigned int next_cursor, unsigned int next_fleet, uint64_t next_mask, uint64_t) {
+			res += get_completions(next_cursor, next_fleet, next_mask);
+		});
+	if (_is_overflow) {
+		return 0;
+	}
+
+	bool is_new;
+	slot = _states.find_or_add(key, is_new);
+	_states.value(slot) = res;
+	return res;
+}
+
+void FleetCounter::add_forward(unsigned int cursor, unsigned int fleet, uint64_t mask, unsigned long long weight)
+{
+	if (fleet == 0 || cursor >= FIELD_CELLS) {
+		return; // nothing to expand
+	}
+	bool is_new;
+	const uint32_t slot = _forward.find_or_add(make_key(cursor, fleet, mask), is_new);
+	if (is_new) {
+		_layer_next[slot] = _layer_heads[cursor];
+		_layer_heads[cursor] = slot;
+	}
+	_forward.value(slot) += weight;
+}
+
+void FleetCounter::expand_forward(uint64_t key, unsigned long long weight, FleetCounts& counts)
+{
+	const unsigned int cursor = static_cast<unsigned int>(key >> (KEY_MASK_BITS + KEY_FLEET_BITS));
+	const unsigned int fleet = static_cast<unsigned int>(key >> KEY_MASK_BITS) & ((1U << KEY_FLEET_BITS) - 1);
+	const uint64_t mask = key & ((1ULL << KEY_MASK_BITS) - 1);
+
+	for_each_transition(cursor, fleet, mask,
+		[&](unsigned int next_cursor, unsigned int next_fleet, uint64_t next_mask, uint64_t boat_cells) {
+			const unsigned long long completions = get_completions(next_cursor, next_fleet, next_mask);
+			if (completions == 0) return;
+
+			for (uint64_t cells = boat_cells; cells != 0; cells &= cells - 1) {
+				counts._cells[cursor + __builtin_ctzll(cells)] += weight * completions;
+			}
+			add_forward(next_cursor, next_fleet, next_mask, weight);
+		});
+}
+
+void FleetCounter::enumerate_state(unsigned int cursor, unsigned int fleet, uint64_t mask, CountedFleet& boats,
+	std::vector<CountedFleet>& fleets)
+{
+	if (fleet == 0) {
+		fleets.push_back(boats);
+		return;
+	}
+
+	for_each_transition(cursor, fleet, mask,
+		[&](unsigned int next_cursor, unsigned int next_fleet, uint64_t next_mask, uint64_t boat_cells) {
+			if (get_completions(next_cursor, next_fleet, next_mask) == 0) return;
+
+			if (boat_cells != 0) {
+				CellBitboard& boat = boats._boats[boats._count++];
+				boat = CellBitboard();
+				for (uint64_t cells = boat_cells; cells != 0; cells &= cells - 1) {
+					boat.set(CellIdx(cursor + __builtin_ctzll(cells)));
+				}
+			}
+			enumerate_state(next_cursor, next_fleet, next_mask, boats, fleets);
+			if (boat_cells != 0) {
+				--boats._count;
+			}
+		});
+}
+
+bool FleetCounter::count(const FieldObservation& obs, const unsigned int* killed_boats_of_size, FleetCounts& counts,
+	const TimePoint* deadline)
+{
+	init(obs, killed_boats_of_size);
+	_deadline = deadline;
+	_expanded = 0;
+
+	counts._total = 0;
+	for (unsigned int cell=0; cell<FIELD_CELLS; ++cell) {
+		counts._cells[cell] = 0;
+	}
+
+	_root_cursor = 0;
+	_root_mask = 0;
+	normalize(_root_cursor, _root_mask);
+	counts._total = get_completions(_root_cursor, _root_fleet, _root_mask);
+	if (_is_overflow) {
+		return false;
+	}
+	if (counts._total == 0) {
+		return true;
+	}
+
+	// all states reachable from the root are in the table now, so the forward pass does not search any more
+	add_forward(_root_cursor, _root_fleet, _root_mask, 1);
+	for (unsigned int layer=0; layer<FIELD_CELLS; ++layer) {
+		if (_deadline != NULL && _layer_heads[layer] != NO_LAYER_SLOT && std::chrono::steady_clock::now() > *_deadline) {
+			_is_overflow = true;
+			return false;
+		}
+		// expanded states are added to the next layers only
+		for (uint32_t slot = _layer_heads[layer]; slot != NO_LAYER_SLOT; slot = _layer_next[slot]) {
+			expand_forward(_forward.get_key(slot), _forward.value(slot), counts);
+		}
+	}
+	return true;
+}
+
+void FleetCounter::enumerate(std::vector<CountedFleet>& fleets)
+{
+	assert(!_is_overflow);
+	fleets.clear();
+	if (get_completions(_root_cursor, _root_fleet, _root_mask) == 0) {
+		return;
+	}
+	CountedFleet boats;
+	boats._count = 0;
+	enumerate_state(_root_cursor, _root_fleet, _root_mask, boats, fleets);
+}
@@ -0,0 +1,114 @@
+#ifndef __FLEET_COUNTER_H__
+#define __FLEET_COUNTER_H__
+
+#include <cstdint>	// for uint64_t, uint32_t
+#include <cstddef>	// for size_t
+#include <vector>	// for std::vector
+#include <chrono>	// for std::chrono::steady_clock
+
+#include <common/cell_idx.h>			// for FIELD_CELLS
+#include <common/cell_bitboard.h>		// for CellBitboard
+#include <common/field_observation.h>	// for FieldObservation
+#include <common/fleet.h>				// for FLEET_BOATS_COUNT, MAX_BOAT_SIZE
+
+// Amount of consistent fleets: in total and with a boat at each cell
+struct FleetCounts {
+	unsigned long long _total;
+	unsigned long long _cells[FIELD_CELLS];
+
+	// hit probability of each cell
+	void get_probabilities(double* probabilities) const
+	{
+		for (unsigned int cell=0; cell<FIELD_CELLS; ++cell) {
+			probabilities[cell] = (_total > 0) ? static_cast<double>(_cells[cell]) / _total : 0;
+		}
+	}
+};
+
+// Alive boats of one consistent fleet
+struct CountedFleet {
+	CellBitboard	_boats[FLEET_BOATS_COUNT];
+	unsigned int	_count;
+};
+
+// Exact counting of all placements of alive boats consistent with the observation.
+// Cells are decided row by row: the cursor cell is either left empty or becomes the head of some boat
+// (so each fleet is counted once). The rest of the search depends only on the remaining fleet and
+// on the cells ahead of the cursor blocked by placed boats, so the counts of such states are memoized
+// in a transposition table. Per-cell counts are collected by the forward pass over the same states:
+// fleets through a transition = (ways to reach the state) * (completions of the next state).
+class FleetCounter {
+public:
+	typedef std::chrono::steady_clock::time_point TimePoint;
+
+	// Counting is abandoned if the search needs more than max_states distinct states
+	explicit FleetCounter(size_t max_states);
+
+	// false if the budget of states is exceeded or the deadline has passed (counts are not valid then)
+	bool count(const FieldObservation& obs, const unsigned int* killed_boats_of_size, FleetCounts& counts,
+		const TimePoint* deadline = NULL);
+
+	// All fleets counted by the last successful count(), use it only when their amount is small
+	void enumerate(std::vector<CountedFleet>& fleets);
+
+	size_t get_max_states() const { return _max_states; }
+	size_t get_states_count() const { return _states.get_size(); }
+
+private:
+	// Open addressing hash map of search states, cleared in O(size)
+	class StateTable {
+	public:
+		explicit StateTable(size_t max_size);
+
+		// Slot of the key: either existing one or a new one with zero value
+		uint32_t find_or_add(uint64_t key, bool& is_new);
+		bool find(uint64_t key, uint32_t& slot) const;
+		void clear();
+
+		uint64_t get_key(uint32_t slot) const { return _keys[slot]; }
+		unsigned long long& value(uint32_t slot) { return _values[slot]; }
+		size_t get_size() const { return _used.size(); }
+		size_t get_capacity() const { return _keys.size(); }
+
+	private:
+		uint32_t get_start(uint64_t key) const;
+
+		std::vector<uint64_t>			_keys;		// 0 means a free slot (the state with no boats is never stored)
+		std::vector<unsigned long long>	_values;
+		std::vector<uint32_t>			_used;		// occupied slots to clear them quickly
+		uint32_t						_slot_mask;
+	};
+
+	void init(const FieldObservation& obs, const unsigned int* killed_boats_of_size);
+	void normalize(unsigned int& cursor, uint64_t& mask) const;
+	template<class Func>
+	void for_each_transition(unsigned int cursor, unsigned int fleet, uint64_t mask, Func func) const;
+	unsigned long long get_completions(unsigned int cursor, unsigned int fleet, uint64_t mask);
+	bool is_harmed_covered(unsigned int cursor, uint64_t mask) const;
+	void add_forward(unsigned int cursor, unsigned int fleet, uint64_t mask, unsigned long long weight);
+	void expand_forward(uint64_t key, unsigned long long weight, FleetCounts& counts);
+	void enumerate_state(unsigned int cursor, unsigned int fleet, uint64_t mask, CountedFleet& boats,
+		std::vector<CountedFleet>& fleets);
+
+	size_t				_max_states;
+	const TimePoint*	_deadline;
+	size_t				_expanded;	// states searched by the current count, the deadline is checked once in a while
+	bool				_is_overflow;
+	unsigned int	_root_cursor;	// normalized root state of the last count
+	unsigned int	_root_fleet;
+	uint64_t		_root_mask;
+
+	// Cells of the observation in the window of 64 cells starting at each cell (bit 0 is the cell itself)
+	uint64_t		_blocked_ahead[FIELD_CELLS];	// missed cells, killed boats with margin, cells beyond the field
+	uint64_t		_harmed_ahead[FIELD_CELLS];
+	unsigned int	_harmed_from[FIELD_CELLS];		// amount of harmed cells starting from each cell
+
+	StateTable				_states;	// completions of each state
+	StateTable				_forward;	// ways to reach each state
+
+	// Forward states by cursor as lists linked through the slots of the forward table (no allocations while counting)
+	uint32_t				_layer_heads[FIELD_CELLS];
+	std::vector<uint32_t>	_layer_next;
+};
+
+#endif // __FLEET_COUNTER_H__
@@ -0,0 +1,221 @@
+#include "lookahead_algo.h"
+
+#include <cstdlib>	// for random()
+#include <utility>	// for std::swap
+
+#include <common/custom_params_parser.h>	// for CustomParamsParser
+
+
+// Adds cells of all free horizontal placements of the boat (vertical ones for the transposed field)
+static unsigned int add_placements(const CellBitboard& free, unsigned int size, bool is_transposed, unsigned int* covers)
+{
+	const uint64_t boat = (1ULL << size) - 1;
+	unsigned int placements = 0;
+	for (unsigned int y=0; y<FIELD_SIZE; ++y) {
+		const uint64_t row = free.get_row(y);
+		for (unsigned int x=0; x+size <= FIELD_SIZE; ++x) {
+			if (((row >> x) & boat) != boat) continue;
+
+			++placements;
+			for (unsigned int i=0; i<size; ++i) {
+				const CellIdx cell(x+i, y);
+				covers[(is_transposed ? cell.transposed() : cell).index()]++;
+			}
+		}
+	}
+	return placements;
+}
+
+// Each alive boat is at any of its free placements with the same probability (independently of other boats)
+void LookaheadStage::get_hit_probabilities(const AlgoContext& ctx, double* probabilities)
+{
+	const FieldObservation& obs = ctx._gdata._obs;
+	const CellBitboard free = ctx._field_m.get_unknown(obs);
+	const CellBitboard free_t = obs._unknown_t.and_not(dilate8(obs._killed_t));
+
+	for (unsigned int i=0; i<FIELD_CELLS; ++i) {
+		probabilities[i] = 0;
+	}
+	for (unsigned int size = 4; size > 0; --size) {
+		const unsigned int remained_boats = 5 - size - ctx._gdata._killed_boats_of_size[size-1];
+		if (remained_boats == 0) continue;
+
+		unsigned int covers[FIELD_CELLS] = {};
+		unsigned int placements = add_placements(free, size, /* is_transposed = */ false, covers);
+		if (size > 1) {
+			placements += add_placements(free_t, size, /* is_transposed = */ true, covers);
+		}
+		if (placements == 0) continue;
+
+		for (unsigned int i=0; i<FIELD_CELLS; ++i) {
+			probabilities[i] += static_cast<double>(remained_boats) * covers[i] / placements;
+		}
+	}
+	for (unsigned int i=0; i<FIELD_CELLS; ++i) {
+		if (probabilities[i] > 1) {
+			probabilities[i] = 1;
+		}
+	}
+}
+
+// The most probable cells to hit, the best first
+void LookaheadStage::get_candidates(const AlgoContext& ctx, const double* probabilities, Candidates& candidates) const
+{
+	const CellBitboard unknown = ctx._field_m.get_unknown(ctx._gdata._obs);
+	for (CellBitboard cells = unknown; !cells.empty(); ) {
+		const CellIdx cell = cells.first();
+		cells.reset(cell);
+
+		const double probability = probabilities[cell.index()];
+		if (probability <= 0) continue;
+
+		if (candidates.size() < _params._top_k) {
+			candidates.push_back(Candidate{ cell, probability });
+		} else if (probability > candidates[candidates.size()-1]._probability) {
+			candidates[candidates.size()-1] = Candidate{ cell, probability };
+		} else {
+			continue;
+		}
+		for (size_t i=candidates.size()-1; i>0 && candidates[i]._probability > candidates[i-1]._probability; --i) {
+			std::swap(candidates[i], candidates[i-1]);
+		}
+	}
+}
+
+// Probability to hit within depth shots after the shot at the cell has missed
+double LookaheadStage::evaluate_miss(const AlgoSnapshot& snapshot, CellIdx cell, unsigned int depth,
+	const TimePoint* deadline) const
+{
+	AlgoSnapshot fork(snapshot);
+	fork.apply_shot_result(cell, SR_MISSED);
+	const AlgoContext ctx = fork.get_context();
+
+	double probabilities[FIELD_CELLS];
+	get_hit_probabilities(ctx, probabilities);
+	Candidates candidates;
+	get_candidates(ctx, probabilities, candidates);
+
+	double value = 0;
+	for (auto it=candidates.begin(); it != candidates.end(); ++it) {
+		double candidate_value = it->_probability;
+		if (depth > 1 && it->_probability < 1 && (deadline == NULL || std::chrono::steady_clock::now() < *deadline)) {
+			candidate_value += (1 - it->_probability) * evaluate_miss(fork, it->_cell, depth - 1, deadline);
+		}
+		if (candidate_value > value) {
+			value = candidate_value;
+		}
+	}
+	return value;
+}
+
+AlgoStepRes LookaheadStage::get_next_shot_or_bail(AlgoContext& ctx, FieldCoords& coords, ShotHints* shot_hints)
+{
+	// placements of the model do not go through harmed cells, the harmed boat is finished by the previous stage
+	if (ctx._field_m.has_harmed_boat(ctx._gdata._obs) || ctx._budget.is_expired()) {
+		return ASR_NO_GUESS;
+	}
+
+	double probabilities[FIELD_CELLS];
+	get_hit_probabilities(ctx, probabilities);
+	Candidates candidates;
+	get_candidates(ctx, probabilities, candidates);
+	if (candidates.empty()) {
+		return ASR_NO_GUESS;
+	}
+
+	TimePoint deadline;
+	const TimePoint* p_deadline = NULL;
+	if (_params._time_ms > 0) {
+		deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(_params._time_ms);
+		p_deadline = &deadline;
+	}
+	p_deadline = ctx._budget.get_deadline(p_deadline);
+
+	// candidates are tried from the most probable one, so the choice is the best one so far when time is out
+	const AlgoSnapshot snapshot(ctx);
+	FewCells good_shots;
+	double best_value = -1;
+	for (auto it=candidates.begin(); it != candidates.end(); ++it) {
+		if (it != candidates.begin() && p_deadline != NULL && std::chrono::steady_clock::now() >= *p_deadline) {
+			break;
+		}
+
+		double value = it->_probability;
+		if (_params._depth > 1 && it->_probability < 1) {
+			value += (1 - it->_probability) * evaluate_miss(snapshot, it->_cell, _params._depth - 1, p_deadline);
+		}
+		if (value > best_value + SAME_CHOICE_EPSILON) {
+			best_value = value;
+			good_shots.clear();
+		}
+		if (value >= best_value - SAME_CHOICE_EPSILON) {
+			good_shots.push_back(it->_cell);
+		}
+	}
+
+	const CellIdx best = good_shots[random() % good_shots.size()];
+	if (shot_hints != NULL) {
+		FewCells chosen;
+		chosen.push_back(best);
+		fill_probability_hints(probabilities, ctx._field_m.get_unknown(ctx._gdata._obs), chosen, *shot_hints);
+	}
+
+	coords = best.coords();
+	return ASR_OK;
+}
+
+LookaheadAlgo::LookaheadAlgo(const DSBAlgoGenricData& gdata)
+	: PipelineAlgo(gdata)
+{ }
+
+LookaheadAlgo::LookaheadAlgo(const DSBAlgoGenricData& gdata, const LookaheadParams& params)
+	: PipelineAlgo(gdata)
+	, _params(params)
+{
+	get_stage<1>().set_params(params);
+}
+
+DSBAlgoApi* LookaheadAlgo::clone(const DSBAlgoGenricData& gdata) const
+{
+	return new LookaheadAlgo(gdata, _params);
+}
+
+bool LookaheadAlgo::process_custom_params(const std::string& params)
+{
+	CustomParamsParser p(params);
+	if (p.parse_var("la_top_k", _params._top_k)) {
+		std::cout << "LookaheadAlgo accepted custom parameter la_top_k=" << _params._top_k << std::endl;
+	}
+	if (p.parse_var("la_depth", _params._depth)) {
+		std::cout << "LookaheadAlgo accepted custom parameter la_depth=" << _params._depth << std::endl;
+	}
+	if (p.parse_var("la_time_ms", _params._time_ms)) {
+		std::cout << "LookaheadAlgo accepted custom parameter la_time_ms=" << _params._time_ms << std::endl;
+	}
+
+	if (_params._top_k == 0 || _params._top_k > MAX_LOOKAHEAD_TOP_K) {
+		std::cout << "LookaheadAlgo needs la_top_k in range 1.." << MAX_LOOKAHEAD_TOP_K << std::endl;
+		return false;
+	}
+	if (_params._depth == 0 || _params._depth > MAX_LOOKAHEAD_DEPTH) {
+		std::cout << "LookaheadAlgo needs la_depth in range 1.." << MAX_LOOKAHEAD_DEPTH << std::endl;
+		return false;
+	}
+	return true;
+}
+
+std::string LookaheadAlgo::get_custom_params_usage() const
+{
+	std::string usage("la_top_k=<uint,1..");
+	usage += std::to_string(MAX_LOOKAHEAD_TOP_K);
+	usage += ",default=";
+	usage += std::to_string(_params._top_k);
+	usage += ">:la_depth=<uint,1..";
+	usage += std::to_string(MAX_LOOKAHEAD_DEPTH);
+	usage += ",default=";
+	usage += std::to_string(_params._depth);
+	usage += ">:la_time_ms=<uint,0 means no limit,default=";
+	usage += std::to_string(_params._time_ms);
+	usage += ">";
+	return usage;
+}
@@ -0,0 +1,72 @@
+#ifndef __LOOKAHEAD_ALGO_H__
+#define __LOOKAHEAD_ALGO_H__
+
+#include <chrono>	// for std::chrono::steady_clock
+
+#include <algo/common/pipeline_algo.h>
+#include <algo/random_algo/random_algo.h>
+#include <common/fixed_vector.h>	// for FixedVector
+
+#define MAX_LOOKAHEAD_TOP_K 16
+#define MAX_LOOKAHEAD_DEPTH 3
+
+struct LookaheadParams {
+	unsigned int _top_k;	// candidate shots evaluated at each ply
+	unsigned int _depth;	// plies of the lookahead, 1 means the greedy choice
+	unsigned int _time_ms;	// time budget per decision, 0 means no limit
+
+	LookaheadParams()
+		: _top_k(4)
+		, _depth(2)
+		, _time_ms(0)
+	{ }
+};
+
+// Shoot at the cell with the highest probability to hit within the next few shots. Hit probabilities are
+// taken from the density of free placements of alive boats; the most probable cells are tried one or more
+// plies deep by playing their misses on snapshots of the state (a hit ends the lookahead).
+class LookaheadStage {
+public:
+	AlgoStepRes get_next_shot_or_bail(AlgoContext& ctx, FieldCoords& coords, ShotHints* shot_hints);
+
+	void set_params(const LookaheadParams& params)
+	{
+		_params = params;
+	}
+
+private:
+	typedef std::chrono::steady_clock::time_point TimePoint;
+
+	struct Candidate {
+		CellIdx	_cell;
+		double	_probability;
+	};
+	typedef FixedVector<Candidate, MAX_LOOKAHEAD_TOP_K> Candidates;
+
+	static void get_hit_probabilities(const AlgoContext& ctx, double* probabilities);
+	void get_candidates(const AlgoContext& ctx, const double* probabilities, Candidates& candidates) const;
+	double evaluate_miss(const AlgoSnapshot& snapshot, CellIdx cell, unsigned int depth, const TimePoint* deadline) const;
+
+	LookaheadParams	_params;
+};
+
+class LookaheadAlgo
+	: public PipelineAlgo<LookaheadAlgo, TargetHarmedStage, LookaheadStage, RandomStage, FirstUnknownStage>
+{
+public:
+	LookaheadAlgo(const DSBAlgoGenricData& gdata);
+
+	virtual std::string get_algo_name() const override { return "lookahead"; }
+
+	virtual bool process_custom_params(const std::string& params) override;
+	virtual std::string get_custom_params_usage() const override;
+
+	virtual DSBAlgoApi* clone(const DSBAlgoGenricData& gdata) const override;
+
+private:
+	LookaheadAlgo(const DSBAlgoGenricData& gdata, const LookaheadParams& params);
+
+	LookaheadParams	_params;
+};
+
+#endif // __LOOKAHEAD_ALGO_H__
@@ -1,30 +1,43 @@
 #include "mixed_algo.h"
 
-AlgoStepRes MixedAlgo::get_next_shot_or_bail(FieldCoords& coords, ShotHints* shot_hints)
+// The default algo is used for big runs, and the cheap endgame (en_max_cells=12) gains nothing against
+// eclipsed placement while doubling the time of the game, so the solver is off unless asked for
+#define MIXED_ENDGAME_MAX_CELLS 0
+#define MIXED_ENDGAME_MAX_FLEETS 6	// limits of the solver once it is turned on
+#define MIXED_ENDGAME_MAX_NODES 500
+
+EndgameParams MixedAlgo::get_default_endgame_params()
 {
-	// Mixed algo has no own logic, do not reuse it!
-	return ASR_NO_GUESS;
+	EndgameParams params;
+	params._max_cells = MIXED_ENDGAME_MAX_CELLS;
+	params._max_fleets = MIXED_ENDGAME_MAX_FLEETS;
+	params._max_nodes = MIXED_ENDGAME_MAX_NODES;
+	return params;
 }
 
-AlgoStepRes MixedAlgo::get_next_shot(FieldCoords& coords, ShotHints* shot_hints)
-{
-	// Stage1: in case previous shot has harmed some ship we need to finish it
-	if ( _field_m.has_harmed_boat()) {
-		return _field_m.get_next_short_for_harmed_boat(coords, shot_hints);
-	}
+MixedAlgo::MixedAlgo(const DSBAlgoGenricData& gdata)
+	: PipelineAlgo(gdata)
+	, _endgame_params(get_default_endgame_params())
+{ }
 
-	// Stage2: no harmed boats - try shoot via field mask
-	AlgoStepRes res = FieldMaskAlgo::get_next_shot_or_bail(coords, shot_hints);
-	if (res != ASR_NO_GUESS) return res;
+MixedAlgo::MixedAlgo(const DSBAlgoGenricData& gdata, const EndgameParams& endgame_params)
+	: PipelineAlgo(gdata)
+	, _endgame_params(endgame_params)
+{
+	get_stage<0>().set_params(endgame_params);
+}
 
-	// Stage3: field-mask is already shooted - try eclipsed algo
-	res = EclipsedAlgo::get_next_shot_or_bail(coords, shot_hints);
-	if (res != ASR_NO_GUESS) return res;
+DSBAlgoApi* MixedAlgo::clone(const DSBAlgoGenricData& gdata) const
+{
+	return new MixedAlgo(gdata, _endgame_params);
+}
 
-	// Stage4: no eclipse - try random
-	res = RandomAlgo::get_next_shot_or_bail(coords, shot_hints);
-	if (res != ASR_NO_GUESS) return res;
+bool MixedAlgo::process_custom_params(const std::string& params)
+{
+	return _endgame_params.parse(params, "MixedAlgo");
+}
 
-	// Stage5: if random cannot find unknown cell for too long, bail to base dummy algo
-	return BasicAlgo::get_next_shot_or_bail(coords, shot_hints);
+std::string MixedAlgo::get_custom_params_usage() const
+{
+	return _endgame_params.get_usage();
 }
@@ -1,36 +1,34 @@
 #ifndef __MIXED_ALGO_H__
 #define __MIXED_ALGO_H__
 
-#include <algo/common/basic_algo.h>
+#include <algo/common/pipeline_algo.h>
 #include <algo/random_algo/random_algo.h>
 #include <algo/eclipsed_algo/eclipsed_algo.h>
 #include <algo/field_mask_algo/field_mask_algo.h>
+#include <algo/endgame_solver/endgame_solver.h>
 
-class MixedAlgo 
-	: public EclipsedAlgo
-	, public FieldMaskAlgo
+// Field mask at first, when it is already shooted - eclipsed, when there is no eclipse - random;
+// the end of the game is solved exactly
+class MixedAlgo
+	: public PipelineAlgo<MixedAlgo, EndgameStage, TargetHarmedStage, FieldMaskStage, EclipsedStage, RandomStage,
+		FirstUnknownStage>
 {
 public:
-	MixedAlgo(const DSBAlgoGenricData& gdata)
-		: BasicAlgo(gdata)
-		, RandomAlgo(gdata)
-		, EclipsedAlgo(gdata)
-		, FieldMaskAlgo(gdata)
-	{ }
+	MixedAlgo(const DSBAlgoGenricData& gdata);
 
 	virtual std::string get_algo_name() const override { return "mixed"; }
 
-	virtual DSBAlgoApi* clone(const DSBAlgoGenricData& gdata) const override
-	{
-		return new MixedAlgo(gdata);
-	}
-
-	virtual AlgoStepRes get_next_shot_or_bail(FieldCoords& coords, ShotHints* shot_hints) override;
-	virtual AlgoStepRes get_next_shot(FieldCoords& coords, ShotHints* shot_hints) override;
-	virtual AlgoStepRes apply_shot_result(const FieldCoords& coords, ShotResult res) override
-	{
-		return BasicAlgo::apply_shot_result(coords, res);
-	}
+	virtual bool process_custom_params(const std::string& params) override;
+	virtual std::string get_custom_params_usage() const override;
+
+	virtual DSBAlgoApi* clone(const DSBAlgoGenricData& gdata) const override;
+
+private:
+	MixedAlgo(const DSBAlgoGenricData& gdata, const EndgameParams& endgame_params);
+
+	static EndgameParams get_default_endgame_params();
+
+	EndgameParams	_endgame_params;
 };
 
 #endif // __MIXED_ALGO_H__
@@ -0,0 +1,329 @@
+#include "fleet_sampler.h"
+
+#include <cstdlib>	// for random()
+
+#define MAX_RESPAWN_ATTEMPTS 50
+#define BURN_IN_STEPS_PER_BOAT 20
+
+void FleetConstraints::init(const FieldObservation& obs, const unsigned int* killed_boats_of_size)
+{
+	const BoatPlacementsTable& table = get_boat_placements();
+
+	_forbidden = obs._missed | dilate8(obs._killed);
+	_harmed = obs._harmed;
+
+	_count = 0;
+	for (unsigned int size=MAX_BOAT_SIZE; size>0; --size) {
+		const unsigned int alive = (5 - size) - killed_boats_of_size[size-1];
+		for (unsigned int i=0; i<alive; ++i) {
+			_sizes[_count++] = size;
+		}
+	}
+
+	for (unsigned int size=1; size<=MAX_BOAT_SIZE; ++size) {
+		_allowed[size-1].clear();
+		for (BoatPos pos=0; pos<BOAT_PLACEMENTS; ++pos) {
+			const BoatPlacement& info = table.get(size, pos);
+			_is_allowed[size-1][pos] = info._is_valid && (info._cells & _forbidden).empty() &&
+				!info._cells.and_not(_harmed).empty();
+			if (_is_allowed[size-1][pos]) {
+				_allowed[size-1].push_back(pos);
+			}
+		}
+	}
+}
+
+// xorshift64*
+uint32_t FleetSample::get_random(uint32_t n)
+{
+	_rng ^= _rng >> 12;
+	_rng ^= _rng << 25;
+	_rng ^= _rng >> 27;
+	return static_cast<uint32_t>((_rng * 2685821657736338717ULL) >> 32) % n;
+}
+
+void FleetSample::update_cells()
+{
+	const BoatPlacementsTable& table = get_boat_placements();
+	_cells = CellBitboard();
+	for (unsigned int i=0; i<_count; ++i) {
+		_cells |= table.get(_sizes[i], _pos[i])._cells;
+	}
+}
+
+bool FleetSample::is_consistent(const FleetConstraints& c) const
+{
+	if (_count != c._count) {
+		return false;
+	}
+
+	const BoatPlacementsTable& table = get_boat_placements();
+	CellBitboard halo;
+	CellBitboard cells;
+	for (unsigned int i=0; i<_count; ++i) {
+		if (_sizes[i] != c._sizes[i] || !c._is_allowed[_sizes[i]-1][_pos[i]]) {
+			return false;
+		}
+		const BoatPlacement& info = table.get(_sizes[i], _pos[i]);
+		if (!(info._cells & halo).empty()) {
+			return false; // boats touch each other
+		}
+		halo |= info._halo;
+		cells |= info._cells;
+	}
+	return c._harmed.and_not(cells).empty();
+}
+
+// Random placement of all boats: boats covering harmed cells at first, then the others from the largest ones
+bool FleetSample::respawn(const FleetConstraints& c)
+{
+	const BoatPlacementsTable& table = get_boat_placements();
+	_count = c._count;
+	for (unsigned int i=0; i<_count; ++i) {
+		_sizes[i] = c._sizes[i];
+	}
+
+	for (unsigned int attempt=0; attempt<MAX_RESPAWN_ATTEMPTS; ++attempt) {
+		bool is_placed[FLEET_BOATS_COUNT] = {};
+		CellBitboard halo;
+		CellBitboard uncovered = c._harmed;
+		bool is_ok = true;
+
+		while (is_ok && !uncovered.empty()) {
+			const CellIdx cell = uncovered.select(get_random(uncovered.count()));
+
+			// reservoir sampling of (boat, position) which covers the cell
+			unsigned int n = 0;
+			unsigned int boat = 0;
+			BoatPos boat_pos = 0;
+			for (unsigned int i=0; i<_count; ++i) {
+				// boats of the same size are equal, try only the first one which is not placed yet
+				if (is_placed[i] || (i > 0 && _sizes[i] == _sizes[i-1] && !is_placed[i-1])) continue;
+
+				for (BoatPos pos : c._allowed[_sizes[i]-1]) {
+					const BoatPlacement& info = table.get(_sizes[i], pos);
+					if (info._cells.test(cell) && (info._cells & halo).empty() && get_random(++n) == 0) {
+						boat = i;
+						boat_pos = pos;
+					}
+				}
+			}
+
+			if (n == 0) {
+				is_ok = false;
+				break;
+			}
+			const BoatPlacement& info = table.get(_sizes[boat], boat_pos);
+			_pos[boat] = boat_pos;
+			is_placed[boat] = true;
+			halo |= info._halo;
+			uncovered = uncovered.and_not(info._cells);
+		}
+
+		for (unsigned int i=0; i<_count && is_ok; ++i) {
+			if (is_placed[i]) continue;
+
+			unsigned int n = 0;
+			for (BoatPos pos : c._allowed[_sizes[i]-1]) {
+				if ((table.get(_sizes[i], pos)._cells & halo).empty() && get_random(++n) == 0) {
+					_pos[i] = pos;
+				}
+			}
+
+			if (n == 0) {
+				is_ok = false;
+				break;
+			}
+			halo |= table.get(_sizes[i], _pos[i])._halo;
+		}
+
+		if (is_ok) {
+			update_cells();
+			return true;
+		}
+	}
+	return false;
+}
+
+bool FleetSample::try_move(const FleetConstraints& c, unsigned int i, BoatPos pos)
+{
+	if (!c._is_allowed[_sizes[i]-1][pos]) {
+		return false;
+	}
+
+	const BoatPlacementsTable& table = get_boat_placements();
+	CellBitboard others_halo;
+	CellBitboard others_cells;
+	for (unsigned int j=0; j<_count; ++j) {
+		if (j == i) continue;
+		const BoatPlacement& info = table.get(_sizes[j], _pos[j]);
+		others_halo |= info._halo;
+		others_cells |= info._cells;
+	}
+
+	const CellBitboard& cells = table.get(_sizes[i], pos)._cells;
+	if (!(cells & others_halo).empty() || !c._harmed.and_not(cells | others_cells).empty()) {
+		return false;
+	}
+
+	_pos[i] = pos;
+	_cells = cells | others_cells;
+	return true;
+}
+
+// Boats of different sizes exchange their positions (head and orientation)
+bool FleetSample::try_swap(const FleetConstraints& c, unsigned int i, unsigned int j)
+{
+	if (!c._is_allowed[_sizes[i]-1][_pos[j]] || !c._is_allowed[_sizes[j]-1][_pos[i]]) {
+		return false;
+	}
+
+	const BoatPlacementsTable& table = get_boat_placements();
+	CellBitboard others_halo;
+	CellBitboard others_cells;
+	for (unsigned int k=0; k<_count; ++k) {
+		if (k == i || k == j) continue;
+		const BoatPlacement& info = table.get(_sizes[k], _pos[k]);
+		others_halo |= info._halo;
+		others_cells |= info._cells;
+	}
+
+	const BoatPlacement& info_i = table.get(_sizes[i], _pos[j]);
+	const BoatPlacement& info_j = table.get(_sizes[j], _pos[i]);
+	if (!(info_i._cells & (others_halo | info_j._halo)).empty() || !(info_j._cells & others_halo).empty()) {
+		return false;
+	}
+	CellBitboard cells = others_cells | info_i._cells | info_j._cells;
+	if (!c._harmed.and_not(cells).empty()) {
+		return false;
+	}
+
+	BoatPos pos = _pos[i];
+	_pos[i] = _pos[j];
+	_pos[j] = pos;
+	_cells = cells;
+	return true;
+}
+
+// Metropolis step for the uniform distribution over consistent fleets: all proposals are symmetric,
+// so a proposal is accepted if it gives a consistent fleet
+void FleetSample::step(const FleetConstraints& c)
+{
+	const unsigned int i = get_random(_count);
+	const unsigned int size = _sizes[i];
+	const unsigned int move = get_random(8);
+
+	if (move < 4) {
+		// move the boat to any allowed position
+		const FixedVector<BoatPos, BOAT_PLACEMENTS>& allowed = c._allowed[size-1];
+		try_move(c, i, allowed[get_random(allowed.size())]);
+	} else if (move < 7) {
+		// shift the boat by one cell or rotate it around the head
+		const unsigned int dir = get_random(CD_COUNT + 1);
+		const bool is_vertical = (_pos[i] >= FIELD_CELLS);
+		if (dir < CD_COUNT) {
+			const CellIdx head = get_neighbour(CellIdx(_pos[i] % FIELD_CELLS), static_cast<CellDirection>(dir));
+			if (!head.is_none()) {
+				try_move(c, i, (is_vertical ? FIELD_CELLS : 0) + head.index());
+			}
+		} else if (size > 1) {
+			try_move(c, i, is_vertical ? _pos[i] - FIELD_CELLS : _pos[i] + FIELD_CELLS);
+		}
+	} else {
+		const unsigned int j = get_random(_count);
+		if (_sizes[j] != size) {
+			try_swap(c, i, j);
+		}
+	}
+}
+
+bool FleetSampler::update(const FieldObservation& obs, const unsigned int* killed_boats_of_size, unsigned int killed_boats,
+	unsigned int chains_count)
+{
+	const BoatPlacementsTable& table = get_boat_placements();
+	_constraints.init(obs, killed_boats_of_size);
+	if (_constraints._count == 0) {
+		return false; // all boats are killed
+	}
+
+	if (chains_count > MAX_SAMPLER_CHAINS) {
+		chains_count = MAX_SAMPLER_CHAINS;
+	}
+	while (_chains_count < chains_count) {
+		FleetSample& s = _chains[_chains_count++];
+		s._count = 0; // inconsistent, will be respawned
+		s._rng = ((static_cast<uint64_t>(random()) << 32) ^ random()) | 1;
+	}
+	_chains_count = chains_count;
+
+	// the killed boat is removed from samples which have it at the same place (the others are respawned)
+	if (killed_boats != _killed_boats) {
+		_killed_boats = killed_boats;
+		for (unsigned int ch=0; ch<_chains_count; ++ch) {
+			FleetSample& s = _chains[ch];
+			unsigned int k = 0;
+			for (unsigned int i=0; i<s._count; ++i) {
+				if (table.get(s._sizes[i], s._pos[i])._cells.and_not(obs._killed).empty()) continue;
+				s._pos[k] = s._pos[i];
+				s._sizes[k++] = s._sizes[i];
+			}
+			s._count = k;
+		}
+	}
+
+	bool is_ok[MAX_SAMPLER_CHAINS];
+	bool is_respawn_failed = false;
+	int good = -1;
+	for (unsigned int ch=0; ch<_chains_count; ++ch) {
+		FleetSample& s = _chains[ch];
+		is_ok[ch] = s.is_consistent(_constraints);
+		if (!is_ok[ch] && !is_respawn_failed) {
+			// once respawn fails the rest of chains are copied from good ones (it would fail as well)
+			is_ok[ch] = s.respawn(_constraints);
+			is_respawn_failed = !is_ok[ch];
+			for (unsigned int i=0; is_ok[ch] && i<BURN_IN_STEPS_PER_BOAT*s._count; ++i) {
+				s.step(_constraints);
+			}
+		}
+		if (is_ok[ch]) {
+			good = ch;
+		}
+	}
+	if (good < 0) {
+		return false;
+	}
+
+	for (unsigned int ch=0; ch<_chains_count; ++ch) {
+		if (is_ok[ch]) continue;
+		FleetSample& s = _chains[ch];
+		const uint64_t rng = s._rng;
+		s = _chains[good];
+		s._rng = rng;
+		for (unsigned int i=0; i<BURN_IN_STEPS_PER_BOAT*s._count; ++i) {
+			s.step(_constraints);
+		}
+	}
+	return true;
+}
+
+unsigned long long FleetSampler::sample(unsigned int first, unsigned int last, unsigned long long steps_count,
+	const TimePoint* deadline, unsigned int* counts)
+{
+	unsigned long long steps = 0;
+	for (unsigned int ch=first; steps<steps_count; ch = (ch+1 < last) ? ch+1 : first) {
+		// the deadline is checked before the first step as well, it may be passed by the previous stages
+		if ((steps & 0xFF) == 0 && deadline != NULL && std::chrono::steady_clock::now() >= *deadline) {
+			break;
+		}
+
+		FleetSample& s = _chains[ch];
+		s.step(_constraints);
+		for (CellBitboard cells = s._cells; !cells.empty(); ) {
+			CellIdx cell = cells.first();
+			cells.reset(cell);
+			counts[cell.index()]++;
+		}
+		++steps;
+	}
+	return steps;
+}
@@ -0,0 +1,82 @@
+#ifndef __FLEET_SAMPLER_H__
+#define __FLEET_SAMPLER_H__
+
+#include <cstdint>	// for uint8_t, uint16_t, uint64_t
+#include <chrono>	// for std::chrono::steady_clock
+
+#include <common/cell_bitboard.h>		// for CellBitboard
+#include <common/field_observation.h>	// for FieldObservation
+#include <common/fixed_vector.h>		// for FixedVector
+#include <common/fleet.h>				// for FLEET_BOATS_COUNT, MAX_BOAT_SIZE, BOAT_PLACEMENTS
+
+#define MAX_SAMPLER_CHAINS 64
+
+// Position of the boat of known size, the placement index of BoatPlacementsTable
+typedef uint16_t BoatPos;
+
+// Constraints for alive boats derived from the observation
+struct FleetConstraints {
+	CellBitboard	_forbidden;	// missed cells, killed boats and their margin
+	CellBitboard	_harmed;	// each harmed cell must be covered by some alive boat
+	uint8_t			_sizes[FLEET_BOATS_COUNT];	// sizes of alive boats in decreasing order
+	unsigned int	_count;
+
+	// positions of each size which fit into the field, do not cover forbidden cells and are not harmed completely
+	// (such boat would be killed already)
+	FixedVector<BoatPos, BOAT_PLACEMENTS> _allowed[MAX_BOAT_SIZE];
+	bool _is_allowed[MAX_BOAT_SIZE][BOAT_PLACEMENTS];
+
+	void init(const FieldObservation& obs, const unsigned int* killed_boats_of_size);
+};
+
+// Configuration of alive boats consistent with the observation, the state of one Markov chain
+struct FleetSample {
+	BoatPos			_pos[FLEET_BOATS_COUNT];
+	uint8_t			_sizes[FLEET_BOATS_COUNT];	// the same order as FleetConstraints::_sizes
+	unsigned int	_count;
+	CellBitboard	_cells;	// cells of all boats
+	uint64_t		_rng;	// own random generator, so chains can be run by different threads
+
+	bool is_consistent(const FleetConstraints& c) const;
+	bool respawn(const FleetConstraints& c);
+	void step(const FleetConstraints& c);
+
+private:
+	uint32_t get_random(uint32_t n);
+	bool try_move(const FleetConstraints& c, unsigned int i, BoatPos pos);
+	bool try_swap(const FleetConstraints& c, unsigned int i, unsigned int j);
+	void update_cells();
+};
+
+// Pool of fleets consistent with the observation, sampled by MCMC moves (move, rotate or swap a boat).
+// Samples which contradict a new observation are respawned.
+class FleetSampler {
+public:
+	FleetSampler()
+		: _chains_count(0)
+		, _killed_boats(0)
+	{ }
+
+	// Prepare the pool for the current observation; false if no consistent fleet is found
+	bool update(const FieldObservation& obs, const unsigned int* killed_boats_of_size, unsigned int killed_boats,
+		unsigned int chains_count);
+
+	// Run steps of chains [first, last) until steps_count is reached or the deadline (if any) is passed;
+	// boat cells of each step are added to counts. Returns the amount of steps done.
+	typedef std::chrono::steady_clock::time_point TimePoint;
+	unsigned long long sample(unsigned int first, unsigned int last, unsigned long long steps_count,
+		const TimePoint* deadline, unsigned int* counts);
+
+	unsigned int get_chains_count() const
+	{
+		return _chains_count;
+	}
+
+private:
+	FleetConstraints	_constraints;
+	FleetSample			_chains[MAX_SAMPLER_CHAINS];
+	unsigned int		_chains_count;
+	unsigned int		_killed_boats;	// killed boats when the pool was updated last time
+};
+
+#endif // __FLEET_SAMPLER_H__
@@ -0,0 +1,309 @@
+#include "montecarlo_algo.h"
+
+#include <atomic>				// for std::atomic
+#include <thread>				// for std::thread
+#include <mutex>				// for std::mutex, std::lock_guard, std::unique_lock
+#include <condition_variable>	// for std::condition_variable
+#include <cassert>				// for assert()
+#include <cstdlib>				// for random()
+
+#include <common/custom_params_parser.h>	// for CustomParamsParser
+
+// Threads playing games with sampling right now (each one plays one game at a time), spare cores are shared
+// between them. Forks of the game (salvo turns) run on the thread of the game, so they are not counted.
+static std::atomic<unsigned int> g_active_games(0);
+
+static unsigned int get_threads_count(const MonteCarloParams& params)
+{
+	unsigned int threads = params._threads;
+	if (threads == 0) {
+		const unsigned int cpus = std::thread::hardware_concurrency();
+		const unsigned int games = g_active_games.load();
+		threads = (games > 0 && cpus > games) ? cpus / games : 1;
+	}
+	const unsigned int chains = (params._chains < MAX_SAMPLER_CHAINS) ? params._chains : MAX_SAMPLER_CHAINS;
+	if (threads > chains) {
+		threads = chains; // each thread runs its own chains
+	}
+	return (threads > 0) ? threads : 1;
+}
+
+// Workers which sample chains of the pool together with the calling thread. Workers are started
+// once and wait for the next decision, each one counts into its own array.
+class SamplingPool {
+public:
+	typedef FleetSampler::TimePoint TimePoint;
+
+	SamplingPool()
+		: _workers_count(0)
+		, _sampler(NULL)
+		, _threads(0)
+		, _steps_count(0)
+		, _deadline(NULL)
+		, _generation(0)
+		, _pending(0)
+		, _is_stopping(false)
+	{
+		g_active_games++;
+	}
+
+	~SamplingPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_is_stopping = true;
+		}
+		_wake.notify_all();
+		for (unsigned int w=0; w<_workers_count; ++w) {
+			_workers[w].join();
+		}
+		g_active_games--;
+	}
+
+	void reserve(unsigned int workers)
+	{
+		while (_workers_count < workers && _workers_count < MAX_SAMPLER_CHAINS-1) {
+			_workers[_workers_count] = std::thread(&SamplingPool::run, this, _workers_count);
+			++_workers_count;
+		}
+	}
+
+	unsigned int get_workers_count() const
+	{
+		return _workers_count;
+	}
+
+	// Chains are split between the calling thread and threads-1 workers
+	unsigned long long sample(FleetSampler& sampler, unsigned int threads, unsigned long long steps_count,
+		const TimePoint* deadline, unsigned int* counts)
+	{
+		assert(threads > 1 && threads <= _workers_count + 1);
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_sampler = &sampler;
+			_threads = threads;
+			_steps_count = steps_count;
+			_deadline = deadline;
+			_pending = threads - 1;
+			++_generation;
+		}
+		_wake.notify_all();
+
+		const unsigned int chains = sampler.get_chains_count();
+		unsigned long long samples = sampler.sample(0, chains/threads, steps_count/threads, deadline, counts);
+
+		std::unique_lock<std::mutex> lock(_mutex);
+		_done.wait(lock, [this]() { return _pending == 0; });
+		for (unsigned int t=1; t<threads; ++t) {
+			samples += _worker_steps[t-1];
+			for (unsigned int i=0; i<FIELD_CELLS; ++i) {
+				counts[i] += _worker_counts[t-1][i];
+			}
+		}
+		return samples;
+	}
+
+private:
+	void run(unsigned int w)
+	{
+		const unsigned int t = w + 1; // the calling thread samples the first chains
+		unsigned long long generation = 0;
+		std::unique_lock<std::mutex> lock(_mutex);
+		while (true) {
+			_wake.wait(lock, [&]() { return _is_stopping || _generation != generation; });
+			if (_is_stopping) {
+				return;
+			}
+			generation = _generation;
+			if (t >= _threads) continue;
+
+			FleetSampler& sampler = *_sampler;
+			const unsigned int threads = _threads;
+			const unsigned long long steps_count = _steps_count;
+			const TimePoint* deadline = _deadline;
+			lock.unlock();
+
+			const unsigned int chains = sampler.get_chains_count();
+			unsigned int* counts = _worker_counts[w];
+			for (unsigned int i=0; i<FIELD_CELLS; ++i) {
+				counts[i] = 0;
+			}
+			_worker_steps[w] = sampler.sample(chains*t/threads, chains*(t+1)/threads, steps_count/threads, deadline,
+				counts);
+
+			lock.lock();
+			if (--_pending == 0) {
+				_done.notify_one();
+			}
+		}
+	}
+
+	std::thread			_workers[MAX_SAMPLER_CHAINS-1];
+	unsigned int		_workers_count;
+	unsigned int		_worker_counts[MAX_SAMPLER_CHAINS-1][FIELD_CELLS];
+	unsigned long long	_worker_steps[MAX_SAMPLER_CHAINS-1];
+
+	// the job of the current decision
+	FleetSampler*		_sampler;
+	unsigned int		_threads;
+	unsigned long long	_steps_count;
+	const TimePoint*	_deadline;
+
+	std::mutex				_mutex;
+	std::condition_variable	_wake;	// a new job or the stop
+	std::condition_variable	_done;	// all workers have finished the job
+	unsigned long long		_generation;	// of the job
+	unsigned int			_pending;		// workers which have not finished the job yet
+	bool					_is_stopping;
+};
+
+static SamplingPool& get_thread_pool()
+{
+	static thread_local SamplingPool pool;
+	return pool;
+}
+
+void MonteCarloStage::set_params(const MonteCarloParams& params)
+{
+	_params = params;
+	// made by the first game of the thread (the pool counts the thread as a playing one at first)
+	SamplingPool& pool = get_thread_pool();
+	pool.reserve(get_threads_count(_params) - 1);
+}
+
+unsigned long long MonteCarloStage::run_sampling(const DecisionBudget& budget, unsigned int* counts)
+{
+	const unsigned int chains = _sampler.get_chains_count();
+
+	FleetSampler::TimePoint deadline;
+	const FleetSampler::TimePoint* p_deadline = NULL;
+	unsigned long long steps_count = _params._samples;
+	if (_params._time_ms > 0) {
+		deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(_params._time_ms);
+		p_deadline = &deadline;
+		steps_count = ~0ULL;
+	}
+	// the budget of the decision can only shorten the sampling
+	p_deadline = budget.get_deadline(p_deadline);
+	steps_count = budget.get_iterations(steps_count);
+
+	// workers are made by set_params(), the decision uses as many of them as there are now
+	unsigned int threads = get_threads_count(_params);
+	if (threads > 1) {
+		SamplingPool& pool = get_thread_pool();
+		if (threads > pool.get_workers_count() + 1) {
+			threads = pool.get_workers_count() + 1;
+		}
+		if (threads > chains) {
+			threads = chains;
+		}
+		if (threads > 1) {
+			return pool.sample(_sampler, threads, steps_count, p_deadline, counts);
+		}
+	}
+	return _sampler.sample(0, chains, steps_count, p_deadline, counts);
+}
+
+AlgoStepRes MonteCarloStage::get_next_shot_or_bail(AlgoContext& ctx, FieldCoords& coords, ShotHints* shot_hints)
+{
+	const DSBAlgoGenricData& gdata = ctx._gdata;
+	if (ctx._budget.is_expired()) {
+		return ASR_NO_GUESS; // the pool is updated by the next decision, it does not depend on the skipped ones
+	}
+	if (!_sampler.update(gdata._obs, gdata._killed_boats_of_size, gdata._killed_boats, _params._chains)) {
+		return ASR_NO_GUESS;
+	}
+
+	unsigned int counts[FIELD_CELLS] = {};
+	const unsigned long long samples = run_sampling(ctx._budget, counts);
+
+	// the most probable cells to hit
+	const CellBitboard unknown = ctx._field_m.get_unknown(gdata._obs);
+	unsigned int max_count = 0;
+	FewCells good_shots;
+	for (CellIdx cell(0); cell.index() < FIELD_CELLS; ++cell._idx) {
+		if (!unknown.test(cell)) continue;
+
+		const unsigned int count = counts[cell.index()];
+		if (count > max_count) {
+			max_count = count;
+			good_shots.clear();
+		}
+		if (count == max_count && count > 0) {
+			good_shots.push_back(cell);
+		}
+	}
+	if (good_shots.empty()) {
+		return ASR_NO_GUESS;
+	}
+
+	if (shot_hints != NULL) {
+		double probabilities[FIELD_CELLS];
+		for (unsigned int i=0; i<FIELD_CELLS; ++i) {
+			probabilities[i] = static_cast<double>(counts[i]) / samples;
+		}
+		fill_probability_hints(probabilities, unknown, good_shots, *shot_hints);
+	}
+
+	coords = good_shots[random() % good_shots.size()].coords();
+	return ASR_OK;
+}
+
+MonteCarloAlgo::MonteCarloAlgo(const DSBAlgoGenricData& gdata)
+	: PipelineAlgo(gdata)
+{ }
+
+MonteCarloAlgo::MonteCarloAlgo(const DSBAlgoGenricData& gdata, const MonteCarloParams& params)
+	: PipelineAlgo(gdata)
+	, _params(params)
+{
+	get_stage<0>().set_params(params);
+}
+
+DSBAlgoApi* MonteCarloAlgo::clone(const DSBAlgoGenricData& gdata) const
+{
+	return new MonteCarloAlgo(gdata, _params);
+}
+
+bool MonteCarloAlgo::process_custom_params(const std::string& params)
+{
+	CustomParamsParser p(params);
+	if (p.parse_var("mc_samples", _params._samples)) {
+		std::cout << "MonteCarloAlgo accepted custom parameter mc_samples=" << _params._samples << std::endl;
+	}
+	if (p.parse_var("mc_time_ms", _params._time_ms)) {
+		std::cout << "MonteCarloAlgo accepted custom parameter mc_time_ms=" << _params._time_ms << std::endl;
+	}
+	if (p.parse_var("mc_chains", _params._chains)) {
+		std::cout << "MonteCarloAlgo accepted custom parameter mc_chains=" << _params._chains << std::endl;
+	}
+	if (p.parse_var("mc_threads", _params._threads)) {
+		std::cout << "MonteCarloAlgo accepted custom parameter mc_threads=" << _params._threads << std::endl;
+	}
+
+	if (_params._samples == 0 && _params._time_ms == 0) {
+		std::cout << "MonteCarloAlgo needs mc_samples or mc_time_ms to be positive" << std::endl;
+		return false;
+	}
+	if (_params._chains == 0 || _params._chains > MAX_SAMPLER_CHAINS) {
+		std::cout << "MonteCarloAlgo needs mc_chains in range 1.." << MAX_SAMPLER_CHAINS << std::endl;
+		return false;
+	}
+	return true;
+}
+
+std::string MonteCarloAlgo::get_custom_params_usage() const
+{
+	std::string usage("mc_samples=<uint,default=");
+	usage += std::to_string(_params._samples);
+	usage += ">:mc_time_ms=<uint,default=";
+	usage += std::to_string(_params._time_ms);
+	usage += ">:mc_chains=<uint,1..";
+	usage += std::to_string(MAX_SAMPLER_CHAINS);
+	usage += ",default=";
+	usage += std::to_string(_params._chains);
+	usage += ">:mc_threads=<uint,0 means spare cores,default=";
+	usage += std::to_string(_params._threads);
+	usage += ">";
+	return usage;
+}
@@ -0,0 +1,56 @@
+#ifndef __MONTECARLO_ALGO_H__
+#define __MONTECARLO_ALGO_H__
+
+#include <algo/common/pipeline_algo.h>
+#include <algo/random_algo/random_algo.h>
+#include <algo/montecarlo_algo/fleet_sampler.h>
+
+struct MonteCarloParams {
+	unsigned int _samples;	// MCMC steps (sampled fleets) per decision
+	unsigned int _time_ms;	// time budget per decision, used instead of _samples if set
+	unsigned int _chains;	// size of the pool of fleets
+	unsigned int _threads;	// sampling threads, 0 means to use spare cores
+
+	MonteCarloParams()
+		: _samples(4000)
+		, _time_ms(0)
+		, _chains(16)
+		, _threads(0)
+	{ }
+};
+
+// Shoot at the cell with the highest hit probability over the fleets consistent with all shot results
+class MonteCarloStage {
+public:
+	AlgoStepRes get_next_shot_or_bail(AlgoContext& ctx, FieldCoords& coords, ShotHints* shot_hints);
+
+	// Makes the sampling threads of the calling thread, so decisions do not start threads
+	void set_params(const MonteCarloParams& params);
+
+private:
+	unsigned long long run_sampling(const DecisionBudget& budget, unsigned int* counts);
+
+	MonteCarloParams	_params;
+	FleetSampler		_sampler;
+};
+
+class MonteCarloAlgo
+	: public PipelineAlgo<MonteCarloAlgo, MonteCarloStage, TargetHarmedStage, RandomStage, FirstUnknownStage>
+{
+public:
+	MonteCarloAlgo(const DSBAlgoGenricData& gdata);
+
+	virtual std::string get_algo_name() const override { return "montecarlo"; }
+
+	virtual bool process_custom_params(const std::string& params) override;
+	virtual std::string get_custom_params_usage() const override;
+
+	virtual DSBAlgoApi* clone(const DSBAlgoGenricData& gdata) const override;
+
+private:
+	MonteCarloAlgo(const DSBAlgoGenricData& gdata, const MonteCarloParams& params);
+
+	MonteCarloParams	_params;
+};
+
+#endif // __MONTECARLO_ALGO_H__
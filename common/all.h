@@ -1,2 +1,3 @@
 #include "coords.h"
 #include "field.h"
+#include "fleet.h"
@@ -0,0 +1,32 @@
+#include <new>		// for std::bad_alloc
+#include <cstdlib>	// for malloc(), free()
+
+#include "alloc_counter.h"
+
+static thread_local unsigned long long g_thread_allocations = 0;
+
+unsigned long long get_thread_allocations()
+{
+	return g_thread_allocations;
+}
+
+// Replacement of global allocation functions: array and nothrow versions forward to this one by default
+void* operator new(std::size_t size)
+{
+	++g_thread_allocations;
+	void* p = malloc(size ? size : 1);
+	if (p == NULL) {
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void operator delete(void* p) noexcept
+{
+	free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+	free(p);
+}
@@ -0,0 +1,8 @@
+#ifndef __ALLOC_COUNTER_H__
+#define __ALLOC_COUNTER_H__
+
+// Amount of heap allocations made by the current thread so far
+// (global operator new is replaced to count them, see alloc_counter.cpp)
+unsigned long long get_thread_allocations();
+
+#endif // __ALLOC_COUNTER_H__
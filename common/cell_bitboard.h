@@ -0,0 +1,257 @@
+#ifndef __CELL_BITBOARD_H__
+#define __CELL_BITBOARD_H__
+
+#include <cstdint>	// for uint64_t
+#include <cassert>	// for assert()
+
+#include "coords.h"			// for FIELD_SIZE
+#include "cell_idx.h"		// for CellIdx, FIELD_CELLS
+#include "index_sequence.h"	// for IndexSequence, MakeIndexSequence
+
+#define BITBOARD_WORDS ((FIELD_CELLS + 63) / 64)
+
+// Set of field cells: one bit per cell, bit number is the cell index (CellIdx, cells are numbered row by row),
+// so the order of set bits is the same as the order of scanning the field by rows
+class CellBitboard {
+public:
+	constexpr CellBitboard()
+		: _words{}
+	{ }
+
+	// Bitboard generated at compile time by cells predicate: Pred::is_set(x, y) must be constexpr
+	template<class Pred>
+	static constexpr CellBitboard make()
+	{
+		return CellBitboard(Pred(), typename MakeIndexSequence<BITBOARD_WORDS>::type());
+	}
+
+	void set_all()
+	{
+		for (unsigned int w=0; w<BITBOARD_WORDS; ++w) {
+			_words[w] = ~0ULL;
+		}
+		if (FIELD_CELLS % 64 != 0) {
+			_words[BITBOARD_WORDS-1] = (1ULL << (FIELD_CELLS % 64)) - 1; // bits beyond the field are never set
+		}
+	}
+
+	bool test(CellIdx cell) const
+	{
+		return (_words[cell.index() / 64] >> (cell.index() % 64)) & 1;
+	}
+
+	void set(CellIdx cell)
+	{
+		_words[cell.index() / 64] |= (1ULL << (cell.index() % 64));
+	}
+
+	void reset(CellIdx cell)
+	{
+		_words[cell.index() / 64] &= ~(1ULL << (cell.index() % 64));
+	}
+
+	bool empty() const
+	{
+		for (unsigned int w=0; w<BITBOARD_WORDS; ++w) {
+			if (_words[w] != 0) return false;
+		}
+		return true;
+	}
+
+	CellBitboard operator&(const CellBitboard& b) const
+	{
+		CellBitboard res;
+		for (unsigned int w=0; w<BITBOARD_WORDS; ++w) {
+			res._words[w] = _words[w] & b._words[w];
+		}
+		return res;
+	}
+
+	CellBitboard operator|(const CellBitboard& b) const
+	{
+		CellBitboard res;
+		for (unsigned int w=0; w<BITBOARD_WORDS; ++w) {
+			res._words[w] = _words[w] | b._words[w];
+		}
+		return res;
+	}
+
+	// Cells of the current set which are not in the set b
+	CellBitboard and_not(const CellBitboard& b) const
+	{
+		CellBitboard res;
+		for (unsigned int w=0; w<BITBOARD_WORDS; ++w) {
+			res._words[w] = _words[w] & ~b._words[w];
+		}
+		return res;
+	}
+
+	CellBitboard& operator|=(const CellBitboard& b)
+	{
+		for (unsigned int w=0; w<BITBOARD_WORDS; ++w) {
+			_words[w] |= b._words[w];
+		}
+		return *this;
+	}
+
+	// Move all cells to higher indexes by n (n=1 is x+1, n=FIELD_SIZE is y+1), cells moved beyond the field are lost.
+	// Note: horizontal shifts move the cells of the last column to the first column of the next row (and back).
+	CellBitboard shl(unsigned int n) const
+	{
+		assert(n > 0 && n < 64);
+		CellBitboard res;
+		for (unsigned int w=BITBOARD_WORDS; w-- > 0; ) {
+			res._words[w] = (_words[w] << n) | ((w > 0) ? (_words[w-1] >> (64 - n)) : 0);
+		}
+		res.clear_beyond_field();
+		return res;
+	}
+
+	// Move all cells to lower indexes by n (n=1 is x-1, n=FIELD_SIZE is y-1)
+	CellBitboard shr(unsigned int n) const
+	{
+		assert(n > 0 && n < 64);
+		CellBitboard res;
+		for (unsigned int w=0; w<BITBOARD_WORDS; ++w) {
+			res._words[w] = (_words[w] >> n) | ((w+1 < BITBOARD_WORDS) ? (_words[w+1] << (64 - n)) : 0);
+		}
+		return res;
+	}
+
+	// Cells of the row y as bits 0..FIELD_SIZE-1 (bit x is the cell x)
+	uint64_t get_row(unsigned int y) const
+	{
+		const unsigned int bit = y*FIELD_SIZE;
+		uint64_t row = _words[bit / 64] >> (bit % 64);
+		if (bit % 64 + FIELD_SIZE > 64) {
+			row |= _words[bit / 64 + 1] << (64 - bit % 64);
+		}
+		return row & ((1ULL << FIELD_SIZE) - 1);
+	}
+
+	// Cells starting from the cell as bits 0..63 (bit k is the cell with index cell+k)
+	uint64_t get_window(CellIdx cell) const
+	{
+		const unsigned int bit = cell.index();
+		uint64_t window = _words[bit / 64] >> (bit % 64);
+		if (bit % 64 != 0 && bit / 64 + 1 < BITBOARD_WORDS) {
+			window |= _words[bit / 64 + 1] << (64 - bit % 64);
+		}
+		return window;
+	}
+
+	unsigned int count() const
+	{
+		unsigned int n = 0;
+		for (unsigned int w=0; w<BITBOARD_WORDS; ++w) {
+			n += __builtin_popcountll(_words[w]);
+		}
+		return n;
+	}
+
+	// The first cell of the set, none if the set is empty
+	CellIdx first() const
+	{
+		for (unsigned int w=0; w<BITBOARD_WORDS; ++w) {
+			if (_words[w] != 0) {
+				return CellIdx(w*64 + __builtin_ctzll(_words[w]));
+			}
+		}
+		return CellIdx();
+	}
+
+	// The k-th cell of the set (k is counted from 0 and must be less than count())
+	CellIdx select(unsigned int k) const
+	{
+		for (unsigned int w=0; w<BITBOARD_WORDS; ++w) {
+			unsigned int n = __builtin_popcountll(_words[w]);
+			if (k < n) {
+				return CellIdx(w*64 + select_in_word(_words[w], k));
+			}
+			k -= n;
+		}
+		assert(false); // k is out of range
+		return CellIdx();
+	}
+
+private:
+	void clear_beyond_field()
+	{
+		if (FIELD_CELLS % 64 != 0) {
+			_words[BITBOARD_WORDS-1] &= (1ULL << (FIELD_CELLS % 64)) - 1;
+		}
+	}
+
+	template<class Pred, unsigned int... I>
+	constexpr CellBitboard(Pred, IndexSequence<I...>)
+		: _words{make_word<Pred>(I)...}
+	{ }
+
+	template<class Pred>
+	static constexpr uint64_t make_word(unsigned int w, unsigned int bit = 0)
+	{
+		return (bit == 64) ? 0 :
+			(((w*64 + bit < FIELD_CELLS) && Pred::is_set((w*64 + bit) % FIELD_SIZE, (w*64 + bit) / FIELD_SIZE)) ?
+				(1ULL << bit) : 0) | make_word<Pred>(w, bit + 1);
+	}
+
+	static unsigned int select_in_word(uint64_t word, unsigned int k)
+	{
+		// skip whole bytes at first, then clear lower set bits of the remaining byte
+		unsigned int base = 0;
+		for (;;) {
+			unsigned int n = __builtin_popcountll(word & 0xFF);
+			if (k < n) break;
+			k -= n;
+			word >>= 8;
+			base += 8;
+		}
+		while (k--) {
+			word &= word - 1;
+		}
+		return base + __builtin_ctzll(word);
+	}
+
+	uint64_t _words[BITBOARD_WORDS];
+};
+
+struct FirstColumnCells {
+	static constexpr bool is_set(unsigned int x, unsigned int /* y */) { return x == 0; }
+};
+
+struct LastColumnCells {
+	static constexpr bool is_set(unsigned int x, unsigned int /* y */) { return x == FIELD_SIZE-1; }
+};
+
+// Shift by one column without wrapping the cells to the neighbour row
+inline CellBitboard shift_right(const CellBitboard& b)
+{
+	static constexpr CellBitboard first_column = CellBitboard::make<FirstColumnCells>();
+	return b.shl(1).and_not(first_column);
+}
+
+inline CellBitboard shift_left(const CellBitboard& b)
+{
+	static constexpr CellBitboard last_column = CellBitboard::make<LastColumnCells>();
+	return b.shr(1).and_not(last_column);
+}
+
+// Cells horizontally adjacent to the set ones (the set cells themselves are included only if they are adjacent)
+inline CellBitboard get_h_neighbours(const CellBitboard& b)
+{
+	return shift_left(b) | shift_right(b);
+}
+
+inline CellBitboard get_v_neighbours(const CellBitboard& b)
+{
+	return b.shl(FIELD_SIZE) | b.shr(FIELD_SIZE);
+}
+
+// Set cells plus all cells around them (including diagonal ones)
+inline CellBitboard dilate8(const CellBitboard& b)
+{
+	CellBitboard row = b | get_h_neighbours(b);
+	return row | get_v_neighbours(row);
+}
+
+#endif // __CELL_BITBOARD_H__
@@ -0,0 +1,89 @@
+#ifndef __CELL_IDX_H__
+#define __CELL_IDX_H__
+
+#include <cstdint>	// for uint8_t
+
+#include "coords.h"			// for FIELD_SIZE, FieldCoords
+#include "index_sequence.h"	// for IndexSequence, MakeIndexSequence
+
+#define FIELD_CELLS (FIELD_SIZE*FIELD_SIZE)
+
+static_assert(FIELD_CELLS < 256, "Cell index of the field must fit into a byte");
+
+// Compact cell coords for hot paths: linear index of the cell (row by row, index = y*FIELD_SIZE + x) in one byte.
+// FieldCoords remains the type of APIs between the engine, algos and visuals.
+struct CellIdx {
+	static constexpr uint8_t NONE = 0xFF;	// no cell (beyond the field)
+
+	uint8_t _idx;
+
+	constexpr CellIdx()
+		: _idx(NONE)
+	{ }
+
+	constexpr explicit CellIdx(unsigned int idx)
+		: _idx(static_cast<uint8_t>(idx))
+	{ }
+
+	constexpr CellIdx(unsigned int x, unsigned int y)
+		: _idx(static_cast<uint8_t>(y*FIELD_SIZE + x))
+	{ }
+
+	CellIdx(const FieldCoords& coords)
+		: _idx(static_cast<uint8_t>(coords._y*FIELD_SIZE + coords._x))
+	{ }
+
+	constexpr unsigned int index() const { return _idx; }
+	constexpr unsigned int x() const { return _idx % FIELD_SIZE; }
+	constexpr unsigned int y() const { return _idx / FIELD_SIZE; }
+	constexpr bool is_none() const { return _idx == NONE; }
+
+	// The same cell of the field with x and y swapped
+	constexpr CellIdx transposed() const { return CellIdx(y(), x()); }
+
+	FieldCoords coords() const
+	{
+		return FieldCoords(x(), y());
+	}
+
+	constexpr bool operator==(const CellIdx& b) const { return _idx == b._idx; }
+	constexpr bool operator!=(const CellIdx& b) const { return _idx != b._idx; }
+};
+
+enum CellDirection { CD_LEFT = 0, CD_RIGHT, CD_UP, CD_DOWN, CD_COUNT };
+
+// Neighbours of the cell in all 4 directions (CellIdx::NONE if the cell is at the border)
+struct CellNeighbours {
+	uint8_t _cells[CD_COUNT];
+};
+
+constexpr uint8_t get_cell_neighbour(unsigned int idx, unsigned int dir)
+{
+	return
+		(dir == CD_LEFT)  ? ((idx % FIELD_SIZE > 0)				? idx - 1			: CellIdx::NONE) :
+		(dir == CD_RIGHT) ? ((idx % FIELD_SIZE < FIELD_SIZE-1)	? idx + 1			: CellIdx::NONE) :
+		(dir == CD_UP)    ? ((idx / FIELD_SIZE > 0)				? idx - FIELD_SIZE	: CellIdx::NONE) :
+		                    ((idx / FIELD_SIZE < FIELD_SIZE-1)	? idx + FIELD_SIZE	: CellIdx::NONE);
+}
+
+constexpr CellNeighbours get_cell_neighbours(unsigned int idx)
+{
+	return CellNeighbours{{ get_cell_neighbour(idx, CD_LEFT), get_cell_neighbour(idx, CD_RIGHT),
+		get_cell_neighbour(idx, CD_UP), get_cell_neighbour(idx, CD_DOWN) }};
+}
+
+// Compile-time table of neighbours of all cells
+template<class Indices> struct CellNeighboursTable;
+template<unsigned int... I>
+struct CellNeighboursTable<IndexSequence<I...>> {
+	static constexpr CellNeighbours _table[sizeof...(I)] = { get_cell_neighbours(I)... };
+};
+template<unsigned int... I>
+constexpr CellNeighbours CellNeighboursTable<IndexSequence<I...>>::_table[sizeof...(I)];
+
+inline CellIdx get_neighbour(CellIdx cell, CellDirection dir)
+{
+	return CellIdx(CellNeighboursTable<MakeIndexSequence<FIELD_CELLS>::type>::_table[cell._idx]._cells[dir]);
+}
+
+#endif // __CELL_IDX_H__
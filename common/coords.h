@@ -160,7 +160,7 @@ public:
 	{
 		FieldCoords coord = cur();
 		do {
-			pi._info[coord._x][coord._y] = val;
+			pi.set(coord, val);
 			coord = next();
 		} while (!is_outside());
 	}
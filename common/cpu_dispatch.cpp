@@ -0,0 +1,48 @@
+#include "cpu_dispatch.h"
+
+static const char* const g_cpu_level_names[CPU_LEVEL_COUNT] = {"portable", "sse2", "avx2", "avx512"};
+
+CpuLevel get_cpu_detected_level()
+{
+#if CPU_DISPATCH_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vpopcntdq")) {
+		return CPU_LEVEL_AVX512;
+	}
+	if (__builtin_cpu_supports("avx2")) {
+		return CPU_LEVEL_AVX2;
+	}
+	if (__builtin_cpu_supports("sse2")) {
+		return CPU_LEVEL_SSE2;
+	}
+#endif
+	return CPU_LEVEL_PORTABLE;
+}
+
+// Kernels used before this initialization (by other static initializers) are portable ones
+CpuLevel g_cpu_level = get_cpu_detected_level();
+
+bool set_cpu_level(CpuLevel level)
+{
+	if (level >= CPU_LEVEL_COUNT || level > get_cpu_detected_level()) {
+		return false;
+	}
+	g_cpu_level = level;
+	return true;
+}
+
+const char* get_cpu_level_name(CpuLevel level)
+{
+	return (level < CPU_LEVEL_COUNT) ? g_cpu_level_names[level] : "unknown";
+}
+
+bool get_cpu_level_by_name(const std::string& name, CpuLevel& level)
+{
+	for (int i=0; i<CPU_LEVEL_COUNT; ++i) {
+		if (name == g_cpu_level_names[i]) {
+			level = static_cast<CpuLevel>(i);
+			return true;
+		}
+	}
+	return false;
+}
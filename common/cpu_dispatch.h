@@ -0,0 +1,36 @@
+#ifndef __CPU_DISPATCH_H__
+#define __CPU_DISPATCH_H__
+
+#include <string>	// for std::string
+
+// Instruction set levels of SIMD kernels, each level includes the previous ones
+enum CpuLevel {
+	CPU_LEVEL_PORTABLE = 0,
+	CPU_LEVEL_SSE2,
+	CPU_LEVEL_AVX2,
+	CPU_LEVEL_AVX512,	// AVX512F + VPOPCNTDQ
+	CPU_LEVEL_COUNT
+};
+
+// x86 kernels of all levels are compiled into the same binary with per-function target options
+// (a single binary built without ISA flags), the level is chosen at startup by cpuid
+#if defined(__GNUC__) && !defined(__clang__) && (defined(__x86_64__) || defined(__i386__))
+#define CPU_DISPATCH_X86 1
+#else
+#define CPU_DISPATCH_X86 0
+#endif
+
+// Active level, kernels are called via tables indexed by it: kernels[get_cpu_level()](...)
+extern CpuLevel g_cpu_level;
+
+inline CpuLevel get_cpu_level()
+{
+	return g_cpu_level;
+}
+
+CpuLevel	get_cpu_detected_level();
+bool		set_cpu_level(CpuLevel level);	// force lower level (for testing), must be called before games start
+const char*	get_cpu_level_name(CpuLevel level);
+bool		get_cpu_level_by_name(const std::string& name, CpuLevel& level);
+
+#endif // __CPU_DISPATCH_H__
@@ -0,0 +1,96 @@
+#include <cstring>	// for memcpy()
+#include <bitset>	// for std::bitset
+
+#include "eclipse_score.h"
+
+#if ECLIPSE_SCORE_BITSLICED
+
+// Portable lanes: 16 lanes of 16 bits in 4 64-bit words
+struct Lanes64x4 {
+	uint64_t _w[4];
+};
+
+static inline Lanes64x4 operator&(const Lanes64x4& a, const Lanes64x4& b)
+{
+	return Lanes64x4{{ a._w[0] & b._w[0], a._w[1] & b._w[1], a._w[2] & b._w[2], a._w[3] & b._w[3] }};
+}
+
+static inline Lanes64x4 operator|(const Lanes64x4& a, const Lanes64x4& b)
+{
+	return Lanes64x4{{ a._w[0] | b._w[0], a._w[1] | b._w[1], a._w[2] | b._w[2], a._w[3] | b._w[3] }};
+}
+
+static inline Lanes64x4 operator^(const Lanes64x4& a, const Lanes64x4& b)
+{
+	return Lanes64x4{{ a._w[0] ^ b._w[0], a._w[1] ^ b._w[1], a._w[2] ^ b._w[2], a._w[3] ^ b._w[3] }};
+}
+
+template<class V> static V v_load(const uint16_t* rows);
+
+template<>
+inline Lanes64x4 v_load<Lanes64x4>(const uint16_t* rows)
+{
+	Lanes64x4 res;
+	memcpy(res._w, rows, sizeof(res._w));
+	return res;
+}
+
+static inline void v_store(uint16_t* rows, const Lanes64x4& v)
+{
+	memcpy(rows, v._w, sizeof(v._w));
+}
+
+static inline Lanes64x4 v_shr(const Lanes64x4& v, unsigned int n)
+{
+	// bits shifted from the next lane are dropped
+	const uint64_t lane_mask = (0xFFFFULL >> n) * 0x0001000100010001ULL;
+	return Lanes64x4{{ (v._w[0] >> n) & lane_mask, (v._w[1] >> n) & lane_mask,
+		(v._w[2] >> n) & lane_mask, (v._w[3] >> n) & lane_mask }};
+}
+
+#include "eclipse_score_bitsliced.h"
+
+void get_eclipse_scores_portable(const FieldRow* eclipse, const FieldRow* denied_pos, unsigned int size, EclipseScores& scores)
+{
+	get_eclipse_scores_bitsliced<Lanes64x4>(eclipse, denied_pos, size, scores);
+}
+
+#else
+
+// Rows are too wide for bit-sliced lanes: score each placement separately
+void get_eclipse_scores_portable(const FieldRow* eclipse, const FieldRow* denied_pos, unsigned int size, EclipseScores& scores)
+{
+	FieldRow boat_mask = FieldBitmap::get_boat_initial_mask(size);
+	FieldRow margin_mask = FieldBitmap::get_margin_initial_mask(size);
+
+	for (int x=0; x<FIELD_SIZE; x++) {
+		for (int y=0; y<FIELD_SIZE; y++) {
+			const int r = y - FBC_MIN;
+			if (x > FIELD_SIZE - (int) size || (denied_pos[r] & boat_mask) != 0) {
+				scores._score[y][x] = -1;
+				continue;
+			}
+			scores._score[y][x] = static_cast<signed short>(std::bitset<64>(eclipse[r-1] & margin_mask).count() +
+				std::bitset<64>(eclipse[r] & margin_mask).count() + std::bitset<64>(eclipse[r+1] & margin_mask).count());
+		}
+
+		boat_mask = boat_mask << 1;
+		margin_mask = margin_mask << 1;
+	}
+}
+
+#endif // ECLIPSE_SCORE_BITSLICED
+
+typedef void (*EclipseScoresKernel)(const FieldRow* eclipse, const FieldRow* denied_pos, unsigned int size, EclipseScores& scores);
+
+static const EclipseScoresKernel g_eclipse_scores_kernels[CPU_LEVEL_COUNT] = {
+	get_eclipse_scores_portable,
+	get_eclipse_scores_sse2,
+	get_eclipse_scores_avx2,
+	get_eclipse_scores_avx512
+};
+
+void get_eclipse_scores(const FieldBitmap& eclipse, const FieldBitmap& denied_pos, unsigned int size, EclipseScores& scores)
+{
+	g_eclipse_scores_kernels[get_cpu_level()](eclipse.get_rows(), denied_pos.get_rows(), size, scores);
+}
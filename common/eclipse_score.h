@@ -0,0 +1,28 @@
+#ifndef __ECLIPSE_SCORE_H__
+#define __ECLIPSE_SCORE_H__
+
+#include "coords.h"			// for FIELD_SIZE
+#include "field_bitmap.h"	// for FieldBitmap, FieldRow
+#include "cpu_dispatch.h"	// for CPU_DISPATCH_X86
+
+// Bit-sliced kernels keep the whole bitmap (up to 16 rows of 16 bits) in 256 bits
+#define ECLIPSE_SCORE_BITSLICED (FIELD_BITMAP_ROWS <= 16)
+#define ECLIPSE_SCORE_PLANES 5	// bit-planes of the counters: the margin is up to 6x3 cells
+
+// Eclipse scores of all horizontal placements of the boat of some size, indexed by boat head [y][x]:
+// the amount of eclipsed cells in the margin rectangle around the boat (as FieldBitmap::popcount3() counts them),
+// or -1 if the placement is denied or the boat does not fit into the field
+struct EclipseScores {
+	signed short _score[FIELD_SIZE][FIELD_SIZE];
+};
+
+// Scores all placements of the row at once (bit-sliced counters), the kernel of the active CPU level is used
+void get_eclipse_scores(const FieldBitmap& eclipse, const FieldBitmap& denied_pos, unsigned int size, EclipseScores& scores);
+
+// Kernels (rows are FieldBitmap rows including the border ones)
+void get_eclipse_scores_portable(const FieldRow* eclipse, const FieldRow* denied_pos, unsigned int size, EclipseScores& scores);
+void get_eclipse_scores_sse2(const FieldRow* eclipse, const FieldRow* denied_pos, unsigned int size, EclipseScores& scores);
+void get_eclipse_scores_avx2(const FieldRow* eclipse, const FieldRow* denied_pos, unsigned int size, EclipseScores& scores);
+void get_eclipse_scores_avx512(const FieldRow* eclipse, const FieldRow* denied_pos, unsigned int size, EclipseScores& scores);
+
+#endif // __ECLIPSE_SCORE_H__
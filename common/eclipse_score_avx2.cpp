@@ -0,0 +1,48 @@
+#include <cstdint>	// for uint16_t
+
+#include "eclipse_score.h"
+
+#if CPU_DISPATCH_X86 && ECLIPSE_SCORE_BITSLICED
+
+// Everything below is compiled for AVX2 and must be called only if the CPU supports it
+#pragma GCC push_options
+#pragma GCC target("avx2")
+
+#include <immintrin.h>	// for _mm256_*
+
+// 16 lanes of 16 bits are exactly one AVX2 register (&, |, ^ are native for GCC vector types)
+template<class V> static V v_load(const uint16_t* rows);
+
+template<>
+inline __m256i v_load<__m256i>(const uint16_t* rows)
+{
+	return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rows));
+}
+
+static inline void v_store(uint16_t* rows, __m256i v)
+{
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(rows), v);
+}
+
+static inline __m256i v_shr(__m256i v, unsigned int n)
+{
+	return _mm256_srl_epi16(v, _mm_cvtsi32_si128(n));
+}
+
+#include "eclipse_score_bitsliced.h"
+
+void get_eclipse_scores_avx2(const FieldRow* eclipse, const FieldRow* denied_pos, unsigned int size, EclipseScores& scores)
+{
+	get_eclipse_scores_bitsliced<__m256i>(eclipse, denied_pos, size, scores);
+}
+
+#pragma GCC pop_options
+
+#else
+
+void get_eclipse_scores_avx2(const FieldRow* eclipse, const FieldRow* denied_pos, unsigned int size, EclipseScores& scores)
+{
+	get_eclipse_scores_portable(eclipse, denied_pos, size, scores);
+}
+
+#endif
@@ -0,0 +1,64 @@
+#include <cstdint>	// for uint64_t
+
+#include "eclipse_score.h"
+
+#if CPU_DISPATCH_X86 && ECLIPSE_SCORE_BITSLICED
+
+// Everything below is compiled for AVX-512 and must be called only if the CPU supports AVX512F and VPOPCNTDQ
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx512vpopcntdq")
+
+#include <immintrin.h>	// for _mm512_*
+
+constexpr unsigned int ROW_BITS = sizeof(FieldRow)*8;
+constexpr unsigned int VECTOR_ROWS = 8;	// 64-bit lanes of the vector
+
+// Each 64-bit lane holds 3 bitmap rows around the boat row, so one VPOPCNTQ scores the placements of 8 rows
+void get_eclipse_scores_avx512(const FieldRow* eclipse, const FieldRow* denied_pos, unsigned int size, EclipseScores& scores)
+{
+	constexpr unsigned int VECTORS = (FIELD_SIZE + VECTOR_ROWS - 1) / VECTOR_ROWS;
+	uint64_t rows3[VECTORS*VECTOR_ROWS] = {};
+	uint64_t denied_rows[VECTORS*VECTOR_ROWS] = {};
+	for (int y=0; y<FIELD_SIZE; ++y) {
+		const int r = y - FBC_MIN;
+		rows3[y] = eclipse[r-1] | ((uint64_t) eclipse[r] << ROW_BITS) | ((uint64_t) eclipse[r+1] << (ROW_BITS*2));
+		denied_rows[y] = denied_pos[r];
+	}
+
+	const uint64_t boat_mask = FieldBitmap::get_boat_initial_mask(size);
+	const uint64_t margin_mask = FieldBitmap::get_margin_initial_mask(size);
+	const uint64_t margin_mask3 = margin_mask | (margin_mask << ROW_BITS) | (margin_mask << (ROW_BITS*2));
+
+	for (int x=0; x<FIELD_SIZE; ++x) {
+		if (x > FIELD_SIZE - (int) size) {
+			for (int y=0; y<FIELD_SIZE; ++y) {
+				scores._score[y][x] = -1;
+			}
+			continue;
+		}
+
+		const __m512i margin = _mm512_set1_epi64(margin_mask3 << x);
+		const __m512i boat = _mm512_set1_epi64(boat_mask << x);
+		for (unsigned int v=0; v<VECTORS; ++v) {
+			const __m512i counts = _mm512_popcnt_epi64(_mm512_and_si512(_mm512_loadu_si512(&rows3[v*VECTOR_ROWS]), margin));
+			const __mmask8 blocked = _mm512_test_epi64_mask(_mm512_loadu_si512(&denied_rows[v*VECTOR_ROWS]), boat);
+
+			int64_t res[VECTOR_ROWS];
+			_mm512_storeu_si512(res, _mm512_mask_mov_epi64(counts, blocked, _mm512_set1_epi64(-1)));
+			for (unsigned int i=0; i<VECTOR_ROWS && v*VECTOR_ROWS + i < FIELD_SIZE; ++i) {
+				scores._score[v*VECTOR_ROWS + i][x] = static_cast<signed short>(res[i]);
+			}
+		}
+	}
+}
+
+#pragma GCC pop_options
+
+#else
+
+void get_eclipse_scores_avx512(const FieldRow* eclipse, const FieldRow* denied_pos, unsigned int size, EclipseScores& scores)
+{
+	get_eclipse_scores_portable(eclipse, denied_pos, size, scores);
+}
+
+#endif
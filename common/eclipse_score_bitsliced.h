@@ -0,0 +1,109 @@
+#ifndef __ECLIPSE_SCORE_BITSLICED_H__
+#define __ECLIPSE_SCORE_BITSLICED_H__
+
+// Bit-sliced eclipse scoring shared by the kernels. Lanes type V holds 16 lanes of 16 bits (lane i is the bitmap row i),
+// it must support &, |, ^ and v_load<V>(), v_store(), v_shr() (shift right within each lane).
+// Each kernel includes this file after its target options and lane operations,
+// so the code is compiled for the instruction set of the kernel.
+
+#include "eclipse_score.h"
+
+#if ECLIPSE_SCORE_BITSLICED
+
+namespace {
+
+// 8 bits to 8 bytes (byte i is bit i of b)
+inline uint64_t spread_bits_to_bytes(unsigned int b)
+{
+	return (((b & 0x7F) * 0x0002040810204081ULL) & 0x0101010101010101ULL) | ((uint64_t)(b & 0x80) << 49);
+}
+
+// acc += x (x has 2 planes), all counters of the lanes are added at once
+template<class V>
+inline void add_bitsliced(V* acc, const V& x0, const V& x1)
+{
+	V carry = acc[0] & x0;
+	acc[0] = acc[0] ^ x0;
+
+	V sum = acc[1] ^ x1;
+	V carry1 = (acc[1] & x1) | (carry & sum);
+	acc[1] = sum ^ carry;
+	carry = carry1;
+
+	for (int p=2; p<ECLIPSE_SCORE_PLANES; ++p) {
+		V plane = acc[p];
+		acc[p] = plane ^ carry;
+		carry = plane & carry;
+	}
+}
+
+template<class V>
+void get_eclipse_scores_bitsliced(const FieldRow* eclipse, const FieldRow* denied_pos, unsigned int size, EclipseScores& scores)
+{
+	// padded copy of rows: the neighbour rows are loaded with the offset of one lane
+	uint16_t rows[16 + 2] = {};
+	for (int i=0; i<FIELD_BITMAP_ROWS; ++i) {
+		rows[i+1] = eclipse[i];
+	}
+	uint16_t denied_rows[16] = {};
+	for (int i=0; i<FIELD_BITMAP_ROWS; ++i) {
+		denied_rows[i] = denied_pos[i];
+	}
+
+	const V up = v_load<V>(&rows[0]);
+	const V mid = v_load<V>(&rows[1]);
+	const V down = v_load<V>(&rows[2]);
+
+	// vertical sum of 3 rows (0..3) for each column
+	const V v0 = up ^ mid ^ down;
+	const V v1 = (up & mid) | (down & (up ^ mid));
+
+	// horizontal sum of size+2 columns: counter at bit b is the score of the margin started at b (the boat head is at b+1)
+	V acc[ECLIPSE_SCORE_PLANES];
+	for (int p=0; p<ECLIPSE_SCORE_PLANES; ++p) {
+		acc[p] = v0 ^ v0;
+	}
+	for (unsigned int k=0; k<size+2; ++k) {
+		add_bitsliced(acc, v_shr(v0, k), v_shr(v1, k));
+	}
+
+	// the boat started at bit b is denied if any of its cells is denied
+	const V denied = v_load<V>(denied_rows);
+	V blocked = denied;
+	for (unsigned int k=1; k<size; ++k) {
+		blocked = blocked | v_shr(denied, k);
+	}
+
+	uint16_t planes[ECLIPSE_SCORE_PLANES][16];
+	for (int p=0; p<ECLIPSE_SCORE_PLANES; ++p) {
+		v_store(planes[p], acc[p]);
+	}
+	uint16_t blocked_rows[16];
+	v_store(blocked_rows, blocked);
+
+	// counters of 8 positions are gathered into the bytes of one word
+	for (int y=0; y<FIELD_SIZE; ++y) {
+		const int lane = y - FBC_MIN;
+		for (int x0=0; x0<FIELD_SIZE; x0+=8) {
+			const int margin_bit = x0 - FBC_MIN - 1;
+			uint64_t counters = 0;
+			for (int p=0; p<ECLIPSE_SCORE_PLANES; ++p) {
+				counters |= spread_bits_to_bytes((planes[p][lane] >> margin_bit) & 0xFF) << p;
+			}
+
+			for (int x=x0; x<x0+8 && x<FIELD_SIZE; ++x) {
+				if (x > FIELD_SIZE - (int) size || ((blocked_rows[lane] >> (x - FBC_MIN)) & 1)) {
+					scores._score[y][x] = -1;
+				} else {
+					scores._score[y][x] = static_cast<signed short>((counters >> ((x-x0)*8)) & 0xFF);
+				}
+			}
+		}
+	}
+}
+
+} // namespace
+
+#endif // ECLIPSE_SCORE_BITSLICED
+
+#endif // __ECLIPSE_SCORE_BITSLICED_H__
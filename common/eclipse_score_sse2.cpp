@@ -0,0 +1,70 @@
+#include <cstdint>	// for uint16_t
+
+#include "eclipse_score.h"
+
+#if CPU_DISPATCH_X86 && ECLIPSE_SCORE_BITSLICED
+
+// Everything below is compiled for SSE2 and must be called only if the CPU supports it
+#pragma GCC push_options
+#pragma GCC target("sse2")
+
+#include <emmintrin.h>	// for _mm_*
+
+// 16 lanes of 16 bits in 2 SSE2 registers
+struct Lanes128x2 {
+	__m128i _v[2];
+};
+
+static inline Lanes128x2 operator&(const Lanes128x2& a, const Lanes128x2& b)
+{
+	return Lanes128x2{{ _mm_and_si128(a._v[0], b._v[0]), _mm_and_si128(a._v[1], b._v[1]) }};
+}
+
+static inline Lanes128x2 operator|(const Lanes128x2& a, const Lanes128x2& b)
+{
+	return Lanes128x2{{ _mm_or_si128(a._v[0], b._v[0]), _mm_or_si128(a._v[1], b._v[1]) }};
+}
+
+static inline Lanes128x2 operator^(const Lanes128x2& a, const Lanes128x2& b)
+{
+	return Lanes128x2{{ _mm_xor_si128(a._v[0], b._v[0]), _mm_xor_si128(a._v[1], b._v[1]) }};
+}
+
+template<class V> static V v_load(const uint16_t* rows);
+
+template<>
+inline Lanes128x2 v_load<Lanes128x2>(const uint16_t* rows)
+{
+	return Lanes128x2{{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows)),
+		_mm_loadu_si128(reinterpret_cast<const __m128i*>(rows + 8)) }};
+}
+
+static inline void v_store(uint16_t* rows, const Lanes128x2& v)
+{
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(rows), v._v[0]);
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(rows + 8), v._v[1]);
+}
+
+static inline Lanes128x2 v_shr(const Lanes128x2& v, unsigned int n)
+{
+	const __m128i count = _mm_cvtsi32_si128(n);
+	return Lanes128x2{{ _mm_srl_epi16(v._v[0], count), _mm_srl_epi16(v._v[1], count) }};
+}
+
+#include "eclipse_score_bitsliced.h"
+
+void get_eclipse_scores_sse2(const FieldRow* eclipse, const FieldRow* denied_pos, unsigned int size, EclipseScores& scores)
+{
+	get_eclipse_scores_bitsliced<Lanes128x2>(eclipse, denied_pos, size, scores);
+}
+
+#pragma GCC pop_options
+
+#else
+
+void get_eclipse_scores_sse2(const FieldRow* eclipse, const FieldRow* denied_pos, unsigned int size, EclipseScores& scores)
+{
+	get_eclipse_scores_portable(eclipse, denied_pos, size, scores);
+}
+
+#endif
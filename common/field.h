@@ -3,19 +3,41 @@
 #include <iostream>
 #include <cstring>	// for memset()
 #include <cassert>	// for assert()
+#include <cstdint>	// for uint8_t
 
 #include "coords.h" // for FIELD_SIZE
+#include "cell_idx.h" // for CellIdx
 
 enum FieldPosInfo { FPI_UNKNOWN = 0, FPI_MISSED, FPI_HARMED, FPI_KILLED };
 
+// Cells are stored row by row, each row is padded to FIELD_ROW_STRIDE cells (to keep rows aligned
+// and to scan the field contiguously by y outer and x inner loops)
+#define FIELD_ROW_STRIDE (((FIELD_SIZE) + 15) & ~15)
+
+// Storage type of the cell: enum values are kept in a single byte
+template<typename Element>
+struct FieldCellStorage {
+	typedef Element type;
+};
+
+template<>
+struct FieldCellStorage<FieldPosInfo> {
+	typedef uint8_t type;
+};
+
 // Here we use template because custom algorithms can use similar concept but modified element type
 template<typename Element>
 struct FieldInfoTpl {
 	typedef Element value_type;
+	typedef typename FieldCellStorage<Element>::type storage_type;
 
 	FieldInfoTpl(Element init_value = (Element) 0)
 	{
-		memset(&_info[0][0], (int) init_value, sizeof(_info));
+		for (int y=0; y<FIELD_SIZE; y++) {
+			for (int x=0; x<FIELD_ROW_STRIDE; x++) {
+				_cells[y][x] = (storage_type) init_value;
+			}
+		}
 	}
 
 	Element get(unsigned int x, unsigned int y) const
@@ -23,13 +45,13 @@ struct FieldInfoTpl {
 		assert(x<FIELD_SIZE);
 		assert(y<FIELD_SIZE);
 
-		return _info[x][y];
+		return (Element) _cells[y][x];
 	}
 
-	Element get_or_bail(signed int x, signed int y, Element default_value = 0) const
+	Element get_or_bail(signed int x, signed int y, Element default_value = (Element) 0) const
 	{
 		if (x >= 0 && x < FIELD_SIZE && y >= 0 && y < FIELD_SIZE) {
-			return _info[x][y];
+			return (Element) _cells[y][x];
 		}
 		return default_value;
 	}
@@ -39,6 +61,45 @@ struct FieldInfoTpl {
 		return get(coords._x, coords._y);
 	}
 
+	Element get(CellIdx cell) const
+	{
+		return get(cell.x(), cell.y());
+	}
+
+	void set(unsigned int x, unsigned int y, Element value)
+	{
+		assert(x<FIELD_SIZE);
+		assert(y<FIELD_SIZE);
+
+		_cells[y][x] = (storage_type) value;
+	}
+
+	void set(const FieldCoords& coords, Element value)
+	{
+		set(coords._x, coords._y, value);
+	}
+
+	void set(CellIdx cell, Element value)
+	{
+		set(cell.x(), cell.y(), value);
+	}
+
+	void add(unsigned int x, unsigned int y, Element value)
+	{
+		assert(x<FIELD_SIZE);
+		assert(y<FIELD_SIZE);
+
+		_cells[y][x] += value;
+	}
+
+	// Contiguous cells of the row y
+	const storage_type* get_row(unsigned int y) const
+	{
+		assert(y<FIELD_SIZE);
+
+		return &_cells[y][0];
+	}
+
 	bool in_range(signed int x, signed int y) const
 	{
 		bool is_outsize = (x<0 || y<0 || x>=FIELD_SIZE || y>=FIELD_SIZE);
@@ -48,23 +109,12 @@ struct FieldInfoTpl {
 	void sum(const FieldInfoTpl<Element>& add_source, signed int factor, Element& mix_value, Element& max_value, bool is_source_transponated = false)
 	{
 		// TODO: optimize the sum of single row using SSE
-		if (is_source_transponated) {
-			for (int y=0; y<FIELD_SIZE; y++) {
-				for (int x=0;x<FIELD_SIZE; x++) {
-					Element& d = _info[x][y];
-					d += add_source._info[y][x] * factor;
-					if (mix_value > d) mix_value = d;
-					if (max_value < d) max_value = d;
-				}
-			}
-		} else {
-			for (int y=0; y<FIELD_SIZE; y++) {
-				for (int x=0;x<FIELD_SIZE; x++) {
-					Element& d = _info[y][x];
-					d += add_source._info[y][x] * factor;
-					if (mix_value > d) mix_value = d;
-					if (max_value < d) max_value = d;
-				}
+		for (int y=0; y<FIELD_SIZE; y++) {
+			for (int x=0;x<FIELD_SIZE; x++) {
+				storage_type& d = _cells[y][x];
+				d += (is_source_transponated ? add_source._cells[x][y] : add_source._cells[y][x]) * factor;
+				if (mix_value > d) mix_value = d;
+				if (max_value < d) max_value = d;
 			}
 		}
 	}
@@ -74,13 +124,14 @@ struct FieldInfoTpl {
 		//std::cout << "\n";
 		for (int y=0; y<FIELD_SIZE; y++) {
 			for (int x=0;x<FIELD_SIZE; x++) {
-				std::cout << _info[x][y] << "\t";
+				std::cout << get(x, y) << "\t";
 			}
 			std::cout << "\n";
 		}
 	}
-	
-	Element _info[FIELD_SIZE][FIELD_SIZE];
+
+private:
+	storage_type _cells[FIELD_SIZE][FIELD_ROW_STRIDE];
 };
 
 typedef FieldInfoTpl<FieldPosInfo> FieldInfo;
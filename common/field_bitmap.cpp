@@ -2,6 +2,11 @@
 #include <cstring>
 
 #include "field_bitmap.h"
+#include "cpu_dispatch.h"	// for get_cpu_level()
+
+#if CPU_DISPATCH_X86
+#include <emmintrin.h>	// for _mm_cmpgt_epi8(), _mm_movemask_epi8()
+#endif
 
 FieldBitmap::FieldBitmap(bool is_init /* = true */)
 {
@@ -10,6 +15,17 @@ FieldBitmap::FieldBitmap(bool is_init /* = true */)
 	}
 }
 
+FieldBitmap::FieldBitmap(const CellBitboard& cells)
+{
+	for (int i=0; i<BORDER_EXTRA; i++) {
+		_data[i] = _data[FIELD_SIZE+BORDER_EXTRA+i] = 0;
+	}
+
+	for (int y=0; y<FIELD_SIZE; y++) {
+		_data[y - FBC_MIN] = static_cast<FieldRow>(cells.get_row(y) << BORDER_EXTRA);
+	}
+}
+
 void FieldBitmap::set_border()
 {
 	// calcualte top and bottom border value 0011111111111100
@@ -30,6 +46,94 @@ void FieldBitmap::set_border()
 	}
 }
 
+constexpr FieldRow FIELD_ROW_CELLS = (1ULL << FIELD_SIZE) - 1;
+
+// Cells of the row which are greater than value (or equal to value if is_equal is set)
+static FieldRow get_cells_row_portable(const uint8_t* row, uint8_t value, bool is_equal)
+{
+	FieldRow res = 0;
+	for (int x=0; x<FIELD_SIZE; x++) {
+		if (is_equal ? (row[x] == value) : (row[x] > value)) {
+			res |= (1ULL << x);
+		}
+	}
+	return res;
+}
+
+#if CPU_DISPATCH_X86 && FIELD_ROW_STRIDE == 16
+// The whole padded row of byte cells is compared at once
+__attribute__((target("sse2")))
+static FieldRow get_cells_row_sse2(const uint8_t* row, uint8_t value, bool is_equal)
+{
+	__m128i cells = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row));
+	__m128i values = _mm_set1_epi8(value);
+	__m128i res = is_equal ? _mm_cmpeq_epi8(cells, values) : _mm_cmpgt_epi8(cells, values);
+	return static_cast<FieldRow>(_mm_movemask_epi8(res)) & FIELD_ROW_CELLS;
+}
+#endif
+
+static inline FieldRow get_cells_row(const uint8_t* row, uint8_t value, bool is_equal)
+{
+#if CPU_DISPATCH_X86 && FIELD_ROW_STRIDE == 16
+	if (get_cpu_level() >= CPU_LEVEL_SSE2) {
+		return get_cells_row_sse2(row, value, is_equal);
+	}
+#endif
+	return get_cells_row_portable(row, value, is_equal);
+}
+
+FieldRow get_boat_cells_row(const FieldInfo& field, unsigned int y)
+{
+	static_assert(FPI_HARMED > FPI_MISSED && FPI_KILLED > FPI_MISSED, "boat cells are expected above missed ones");
+	return get_cells_row(field.get_row(y), FPI_MISSED, /* is_equal = */ false);
+}
+
+FieldRow get_boat_cells_row(const PlacementInfo& field, unsigned int y)
+{
+	return get_cells_row(reinterpret_cast<const uint8_t*>(field.get_row(y)), 0, /* is_equal = */ false);
+}
+
+FieldRow get_missed_cells_row(const FieldInfo& field, unsigned int y)
+{
+	return get_cells_row(field.get_row(y), FPI_MISSED, /* is_equal = */ true);
+}
+
+FieldBitmap& FieldBitmap::operator|=(const FieldBitmap& b)
+{
+	for (int i=0; i<FIELD_BITMAP_ROWS; i++) {
+		_data[i] |= b._data[i];
+	}
+	return *this;
+}
+
+FieldBitmap& FieldBitmap::operator&=(const FieldBitmap& b)
+{
+	for (int i=0; i<FIELD_BITMAP_ROWS; i++) {
+		_data[i] &= b._data[i];
+	}
+	return *this;
+}
+
+FieldBitmap& FieldBitmap::and_not(const FieldBitmap& b)
+{
+	for (int i=0; i<FIELD_BITMAP_ROWS; i++) {
+		_data[i] &= ~b._data[i];
+	}
+	return *this;
+}
+
+void FieldBitmap::get_dilated8(const FieldBitmap& src)
+{
+	// dilate each row horizontally, then OR the neighbour rows
+	FieldRow h[FIELD_BITMAP_ROWS];
+	for (int i=0; i<FIELD_BITMAP_ROWS; i++) {
+		h[i] = src._data[i] | (src._data[i] << 1) | (src._data[i] >> 1);
+	}
+	for (int i=0; i<FIELD_BITMAP_ROWS; i++) {
+		_data[i] = h[i] | ((i > 0) ? h[i-1] : 0) | ((i+1 < FIELD_BITMAP_ROWS) ? h[i+1] : 0);
+	}
+}
+
 bool FieldBitmap::is_intersected(signed int y, FieldRow mask) const
 {
 	assert(y >= FBC_MIN && y <= FBC_MAX);
@@ -5,6 +5,7 @@
 
 #include "coords.h" // for FIELD_SIZE
 #include "field.h"	// for FieldInfoTpl, is_boat_cell
+#include "cell_bitboard.h"	// for CellBitboard
 
 #define BORDER_EXTRA 3	// we use extra cells near the border to allow bit-wise operations in generic way
 						// if we have 4-size boat as the larges then we need extra 3 cells beyond the border to allow masking
@@ -21,6 +22,18 @@ typedef uint64_t FieldRow;	// 64 bits as the exteme possibility
 #error Oops too large FIELD_SIZE cannot be handled by single integral FieldRow variable
 #endif
 
+#define FIELD_BITMAP_ROWS (FIELD_SIZE + BORDER_EXTRA*2)
+
+// Row y of the field as a bit mask (bit x is set for the cells of requested kind),
+// the whole row is converted at once (SSE2 compare + movemask over the byte cells of the row if the CPU level allows)
+FieldRow get_boat_cells_row(const FieldInfo& field, unsigned int y);
+FieldRow get_boat_cells_row(const PlacementInfo& field, unsigned int y);
+FieldRow get_missed_cells_row(const FieldInfo& field, unsigned int y);
+
+inline FieldRow get_missed_cells_row(const PlacementInfo& field, unsigned int y)
+{
+	return 0; // placement has no missed cells
+}
 
 class FieldBitmap {
 public:
@@ -29,6 +42,13 @@ public:
 	template<class Element>
 	FieldBitmap(const FieldInfoTpl<Element>& field, bool is_transponate = false);
 
+	// Bitmap of the cells of the set (border cells are not set)
+	explicit FieldBitmap(const CellBitboard& cells);
+
+	// Set cells of the field which are set in the bitmap (cells outside of the field are ignored)
+	template<class Element>
+	void fill_field(FieldInfoTpl<Element>& field, Element value) const;
+
 	template<class Element>
 	void add_eclipse(const FieldInfoTpl<Element>& field, bool is_set_missed = false);
 
@@ -39,16 +59,23 @@ public:
 	void		set_border();
 
 
+	// Whole-board operations (border cells are included)
+	FieldBitmap&	operator|=(const FieldBitmap& b);
+	FieldBitmap&	operator&=(const FieldBitmap& b);
+	FieldBitmap&	and_not(const FieldBitmap& b);
+	void			get_dilated8(const FieldBitmap& src);	// src cells plus all cells around them
+
 	bool		is_intersected(signed int y, FieldRow mask) const;
 	int			popcount3(signed int y, FieldRow mask) const;
 	void		get_transponated(const FieldBitmap& src);
+	const FieldRow* get_rows() const { return _data; }	// FIELD_BITMAP_ROWS rows, the first one is y=FBC_MIN
 
 	static FieldRow	get_1point_mask(signed int x);
 	static FieldRow get_boat_initial_mask(unsigned int size);
 	static FieldRow get_margin_initial_mask(unsigned int size);
 	
 private:
-	FieldRow _data[FIELD_SIZE+BORDER_EXTRA*2];
+	FieldRow _data[FIELD_BITMAP_ROWS];
 };
 
 #include "field_bitmap.hpp"
@@ -7,48 +7,39 @@ FieldBitmap::FieldBitmap(const FieldInfoTpl<Element>& field, bool is_transponate
 	}
 
 	for (int y=0; y<FIELD_SIZE; y++) {
-		FieldRow val = 0;
-		for (int x=0; x<FIELD_SIZE; x++) {
-			FieldCoords coord(x, y);
-			if (is_transponate) {
-				coord.transponate();
-			}
-			if (is_boat_cell(field.get(coord))) {
-				val |= (1ULL << x);
-			}
+		_data[y - FBC_MIN] = (get_boat_cells_row(field, y) << BORDER_EXTRA);
+	}
+
+	if (is_transponate) {
+		FieldBitmap src(*this);
+		get_transponated(src);
+	}
+}
+
+template<class Element>
+void FieldBitmap::fill_field(FieldInfoTpl<Element>& field, Element value) const
+{
+	for (int y=0; y<FIELD_SIZE; y++) {
+		uint64_t val = (_data[y - FBC_MIN] >> BORDER_EXTRA) & ((1ULL << FIELD_SIZE) - 1);
+		while (val != 0) {
+			field.set(__builtin_ctzll(val), y, value);
+			val &= val - 1;
 		}
-		_data[y - FBC_MIN] = (val << BORDER_EXTRA);
 	}
 }
 
 template<class Element>
 void FieldBitmap::add_eclipse(const FieldInfoTpl<Element>& field, bool is_set_missed)
 {
-	for (signed int y=0; y<FIELD_SIZE; y++) {
-		for (signed int x=0; x<FIELD_SIZE; x++) {
-			Element e = field.get(x,y);
-			if (is_boat_cell(e)) {
-#if 1
-				// Optimized flow to set three bits at once
-				FieldRow one_point_mask = get_1point_mask(x);
-				FieldRow threee_points_mask = one_point_mask | (one_point_mask>>1) | (one_point_mask<<1);
-				set_row_mask(y-1, threee_points_mask);
-				set_row_mask(y,   threee_points_mask);
-				set_row_mask(y+1, threee_points_mask);
-#else
-				set(x-1, y-1);
-				set(x-1, y);
-				set(x-1, y+1);
-				set(x, y-1);
-				set(x, y);
-				set(x, y+1);
-				set(x+1, y-1);
-				set(x+1, y);
-				set(x+1, y+1);
-#endif
-			} else if (is_set_missed && is_missed_cell(e)) {
-				set(x, y);
-			}
+	// Eclipse is the boat cells dilated by one cell in all directions
+	FieldBitmap boats(field);
+	FieldBitmap eclipse(/* is_init = */ false);
+	eclipse.get_dilated8(boats);
+	*this |= eclipse;
+
+	if (is_set_missed) {
+		for (int y=0; y<FIELD_SIZE; y++) {
+			_data[y - FBC_MIN] |= (get_missed_cells_row(field, y) << BORDER_EXTRA);
 		}
 	}
 }
@@ -0,0 +1,68 @@
+#ifndef __FIELD_OBSERVATION_H__
+#define __FIELD_OBSERVATION_H__
+
+#include <cassert>	// for assert()
+
+#include "cell_idx.h"		// for CellIdx
+#include "cell_bitboard.h"	// for CellBitboard
+
+// Results of all shots of the game as cell sets (sets do not intersect), maintained by the engine.
+// Each set is kept in both orientations: transposed (_t) sets have x and y swapped,
+// so vertical boats can be processed by the same row-wise code as horizontal ones.
+struct FieldObservation {
+	CellBitboard _unknown;	// cells which are not shot yet (including the margin of killed boats)
+	CellBitboard _missed;
+	CellBitboard _harmed;	// harmed cells of boats which are not killed yet
+	CellBitboard _killed;	// all cells of killed boats
+
+	CellBitboard _unknown_t;
+	CellBitboard _missed_t;
+	CellBitboard _harmed_t;
+	CellBitboard _killed_t;
+
+	FieldObservation()
+	{
+		_unknown.set_all();
+		_unknown_t.set_all();
+	}
+
+	void set_missed(CellIdx cell)
+	{
+		set_shot(cell);
+		_missed.set(cell);
+		_missed_t.set(cell.transposed());
+	}
+
+	void set_harmed(CellIdx cell)
+	{
+		set_shot(cell);
+		_harmed.set(cell);
+		_harmed_t.set(cell.transposed());
+	}
+
+	// boat is all cells of the killed boat, the cell of the last shot is one of them
+	void set_killed(CellIdx cell, const CellBitboard& boat)
+	{
+		assert(boat.test(cell));
+		set_shot(cell);
+		_harmed = _harmed.and_not(boat);
+		_killed |= boat;
+
+		for (CellBitboard cells = boat; !cells.empty(); ) {
+			CellIdx boat_cell = cells.first();
+			cells.reset(boat_cell);
+			_harmed_t.reset(boat_cell.transposed());
+			_killed_t.set(boat_cell.transposed());
+		}
+	}
+
+private:
+	void set_shot(CellIdx cell)
+	{
+		assert(_unknown.test(cell));
+		_unknown.reset(cell);
+		_unknown_t.reset(cell.transposed());
+	}
+};
+
+#endif // __FIELD_OBSERVATION_H__
@@ -0,0 +1,53 @@
+#ifndef __FIXED_VECTOR_H__
+#define __FIXED_VECTOR_H__
+
+#include <cassert>	// for assert()
+#include <cstddef>	// for size_t
+
+// Vector with fixed capacity stored inline (on the stack for local variables): it never allocates memory,
+// so it is used for short lists of cells/placements built at each decision
+template<typename T, size_t Capacity>
+class FixedVector {
+public:
+	typedef T value_type;
+	typedef T* iterator;
+	typedef const T* const_iterator;
+
+	FixedVector()
+		: _size(0)
+	{ }
+
+	void push_back(const T& value)
+	{
+		assert(_size < Capacity);
+		_items[_size++] = value;
+	}
+
+	void clear() { _size = 0; }
+
+	size_t size() const { return _size; }
+	bool empty() const { return _size == 0; }
+
+	T& operator[](size_t i)
+	{
+		assert(i < _size);
+		return _items[i];
+	}
+
+	const T& operator[](size_t i) const
+	{
+		assert(i < _size);
+		return _items[i];
+	}
+
+	iterator begin() { return &_items[0]; }
+	iterator end() { return &_items[_size]; }
+	const_iterator begin() const { return &_items[0]; }
+	const_iterator end() const { return &_items[_size]; }
+
+private:
+	T		_items[Capacity];
+	size_t	_size;
+};
+
+#endif // __FIXED_VECTOR_H__
@@ -0,0 +1,84 @@
+#ifndef __FLEET_H__
+#define __FLEET_H__
+
+#include <cassert>	// for assert()
+
+#include "coords.h"			// for FieldCoords, FIELD_SIZE
+#include "cell_bitboard.h"	// for CellBitboard, dilate8()
+
+// amount of all boats of the fleet (1 x size4 + 2 x size3 + 3 x size2 + 4 x size1)
+#define FLEET_BOATS_COUNT 10
+#define MAX_BOAT_SIZE 4
+#define BOAT_PLACEMENTS (FIELD_CELLS*2)	// horizontal and vertical boats with the head at each cell
+
+// Position of the boat: the top-left cell, size and orientation
+struct BoatDescriptor {
+	FieldCoords		_head;
+	unsigned int	_size;
+	bool			_is_horizontal;
+};
+
+// All boats placed on the field (in the order of placement)
+struct FleetInfo {
+	BoatDescriptor	_boats[FLEET_BOATS_COUNT];
+	unsigned int	_count;
+
+	FleetInfo()
+		: _count(0)
+	{ }
+
+	void add_boat(const FieldCoords& head, bool is_horizontal, unsigned int size)
+	{
+		assert(_count < FLEET_BOATS_COUNT);
+		BoatDescriptor boat = { head, size, is_horizontal };
+		_boats[_count++] = boat;
+	}
+};
+
+// Cells of the boat of known size at some placement: head cell index for horizontal boats,
+// FIELD_CELLS + head cell index for vertical ones
+struct BoatPlacement {
+	CellBitboard	_cells;
+	CellBitboard	_halo;		// the cells and all cells around them
+	bool			_is_valid;	// the boat fits into the field
+};
+
+class BoatPlacementsTable {
+public:
+	BoatPlacementsTable()
+	{
+		for (unsigned int size=1; size<=MAX_BOAT_SIZE; ++size) {
+			for (unsigned int pos=0; pos<BOAT_PLACEMENTS; ++pos) {
+				BoatPlacement& p = _placements[size-1][pos];
+				const CellIdx head(pos % FIELD_CELLS);
+				const bool is_vertical = (pos >= FIELD_CELLS);
+				const unsigned int tail = (is_vertical ? head.y() : head.x()) + size - 1;
+
+				// 1-size boats have only one orientation, so all fleets are counted once
+				p._is_valid = (tail < FIELD_SIZE) && !(is_vertical && size == 1);
+				if (!p._is_valid) continue;
+
+				for (unsigned int k=0; k<size; ++k) {
+					p._cells.set(is_vertical ? CellIdx(head.x(), head.y() + k) : CellIdx(head.x() + k, head.y()));
+				}
+				p._halo = dilate8(p._cells);
+			}
+		}
+	}
+
+	const BoatPlacement& get(unsigned int size, unsigned int pos) const
+	{
+		return _placements[size-1][pos];
+	}
+
+private:
+	BoatPlacement _placements[MAX_BOAT_SIZE][BOAT_PLACEMENTS];
+};
+
+inline const BoatPlacementsTable& get_boat_placements()
+{
+	static const BoatPlacementsTable table;
+	return table;
+}
+
+#endif // __FLEET_H__
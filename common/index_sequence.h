@@ -0,0 +1,11 @@
+#ifndef __INDEX_SEQUENCE_H__
+#define __INDEX_SEQUENCE_H__
+
+// C++11 replacement of std::index_sequence to expand compile-time tables: MakeIndexSequence<N>::type is IndexSequence<0..N-1>
+template<unsigned int... I> struct IndexSequence { };
+template<unsigned int N, unsigned int... I>
+struct MakeIndexSequence : MakeIndexSequence<N-1, N-1, I...> { };
+template<unsigned int... I>
+struct MakeIndexSequence<0, I...> { typedef IndexSequence<I...> type; };
+
+#endif // __INDEX_SEQUENCE_H__
@@ -0,0 +1,78 @@
+#ifndef __LATENCY_HISTOGRAM_H__
+#define __LATENCY_HISTOGRAM_H__
+
+// Histogram of latencies in microseconds. Buckets are log-linear: 8 buckets per each power of two,
+// so percentiles are reported with the precision of 1/8. It is not thread safe: each thread fills
+// its own histogram and they are merged when threads finish.
+class LatencyHistogram {
+public:
+	LatencyHistogram()
+		: _count(0)
+		, _max(0)
+	{
+		for (unsigned int b=0; b<BUCKETS; ++b) _counts[b] = 0;
+	}
+
+	void add(unsigned long long us)
+	{
+		_counts[get_bucket(us)]++;
+		_count++;
+		if (us > _max) _max = us;
+	}
+
+	void merge(const LatencyHistogram& other)
+	{
+		for (unsigned int b=0; b<BUCKETS; ++b) _counts[b] += other._counts[b];
+		_count += other._count;
+		if (other._max > _max) _max = other._max;
+	}
+
+	unsigned long long get_count() const { return _count; }
+	unsigned long long get_max() const { return _max; }
+
+	// Upper bound of the latency of the percentile (0..100] of all added latencies
+	unsigned long long get_percentile(double percentile) const
+	{
+		unsigned long long rank = static_cast<unsigned long long>(_count * percentile / 100);
+		if (rank == 0) rank = 1;
+		unsigned long long seen = 0;
+		for (unsigned int b=0; b<BUCKETS; ++b) {
+			seen += _counts[b];
+			if (seen >= rank) {
+				const unsigned long long limit = get_bucket_limit(b);
+				return (limit < _max) ? limit : _max;
+			}
+		}
+		return _max;
+	}
+
+private:
+	static const unsigned int SUB_BITS = 3;	// 8 buckets per power of two
+	static const unsigned int BUCKETS = (64 - SUB_BITS + 1) << SUB_BITS;
+
+	static unsigned int get_bucket(unsigned long long us)
+	{
+		if (us < (1ULL << SUB_BITS)) {
+			return static_cast<unsigned int>(us); // small latencies are exact
+		}
+		const unsigned int shift = 63 - __builtin_clzll(us) - SUB_BITS;
+		return ((shift + 1) << SUB_BITS) + static_cast<unsigned int>((us >> shift) & ((1ULL << SUB_BITS) - 1));
+	}
+
+	// The largest latency of the bucket
+	static unsigned long long get_bucket_limit(unsigned int bucket)
+	{
+		if (bucket < (1U << SUB_BITS)) {
+			return bucket;
+		}
+		const unsigned int shift = (bucket >> SUB_BITS) - 1;
+		const unsigned long long mantissa = (1ULL << SUB_BITS) + (bucket & ((1U << SUB_BITS) - 1));
+		return (mantissa << shift) + ((1ULL << shift) - 1);
+	}
+
+	unsigned long long	_counts[BUCKETS];
+	unsigned long long	_count;
+	unsigned long long	_max;
+};
+
+#endif // __LATENCY_HISTOGRAM_H__
@@ -0,0 +1,57 @@
+#ifndef __SPSC_QUEUE_H__
+#define __SPSC_QUEUE_H__
+
+#include <atomic>	// for std::atomic
+#include <cstddef>	// for size_t
+#include <utility>	// for std::move
+
+// Lock-free bounded queue for exactly one producer thread and one consumer thread.
+// Slots are pre-allocated; push()/pop() never block and return false if queue is full/empty.
+template<typename T, size_t Capacity>
+class SpscQueue {
+	static_assert(Capacity > 1 && (Capacity & (Capacity-1)) == 0, "SpscQueue capacity must be a power of 2");
+public:
+	SpscQueue()
+		: _head(0)
+		, _tail(0)
+	{ }
+
+	// Producer side
+	bool push(T&& value)
+	{
+		const size_t tail = _tail.load(std::memory_order_relaxed);
+		if (tail - _head.load(std::memory_order_acquire) == Capacity) {
+			return false; // full
+		}
+		_slots[tail & (Capacity-1)] = std::move(value);
+		_tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Consumer side
+	bool pop(T& value)
+	{
+		const size_t head = _head.load(std::memory_order_relaxed);
+		if (head == _tail.load(std::memory_order_acquire)) {
+			return false; // empty
+		}
+		value = std::move(_slots[head & (Capacity-1)]);
+		_head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool empty() const
+	{
+		return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire);
+	}
+
+private:
+	// head and tail are modified by different threads, keep them in different cache lines
+	// (explicit padding instead of alignas: queues are allocated by operator new which ignores extended alignment in C++11)
+	std::atomic<size_t> _head;	// next slot to pop
+	char _pad[64 - sizeof(std::atomic<size_t>)];
+	std::atomic<size_t> _tail;	// next slot to push
+	T _slots[Capacity];
+};
+
+#endif // __SPSC_QUEUE_H__
@@ -3,12 +3,15 @@
 #include <memory>		// for std::unique_ptr
 #include <thread>		// for std::thread
 #include <atomic>		// for std::atomic
+#include <mutex>		// for std::mutex
 #include <vector>		// for std::vector
 #include <string>		// for std::string
+#include <algorithm>	// for std::min, std::max
 #include <iostream>		// for std:cout
 
 #include <time.h>		// for time()
-#include <cstdlib>		// for atoi()
+#include <cstdlib>		// for atoi(), strtoull()
+#include <chrono>		// for std::chrono::steady_clock
 
 #include "placement/random_placement/random_placement.h"
 #include "placement/eclipsed_placement/eclipsed_placement.h"
@@ -17,11 +20,24 @@
 #include "algo/eclipsed_algo/eclipsed_algo.h"
 #include "algo/dummy_algo/dummy_algo.h"
 #include "algo/mixed_algo/mixed_algo.h"
+#include "algo/montecarlo_algo/montecarlo_algo.h"
+#include "algo/exact_algo/exact_algo.h"
+#include "algo/lookahead_algo/lookahead_algo.h"
+#include "algo/distilled_algo/distilled_algo.h"
 #include "dsb_sdl_opengl_visual.h"
 #include "dsb_console_visual.h"
-
-enum VisualEngine {VE_NONE=0, VE_CONSOLE_FULL, VE_CONSOLE_SHORT, VE_SDL_OPENGL};
+#include "dsb_console_ansi_visual.h"
+#include "dsb_ppm_visual.h"
+#include "dsb_analysis.h"
+#include "dsb_distill.h"
+#include "common/spsc_queue.h"
+#include "common/alloc_counter.h"
+#include "common/latency_histogram.h"
+#include "common/cpu_dispatch.h"
+
+enum VisualEngine {VE_NONE=0, VE_CONSOLE_FULL, VE_CONSOLE_SHORT, VE_SDL_OPENGL, VE_PPM, VE_CONSOLE_ANSI};
 enum VisualType {VT_RAW, VT_COMBINED/*, VT_SPLIT */};
+enum LiveView {LV_NONE=0, LV_CONSOLE, LV_SDL_OPENGL};
 
 static VisualEngine g_visual	= VE_SDL_OPENGL;
 static VisualType	g_vtype		= VT_COMBINED;
@@ -29,6 +45,55 @@ static unsigned int g_seed		= time(NULL);
 static unsigned int g_delay		= 100;
 static unsigned int g_num		= 10000;
 static bool			g_key_pause = false;
+static std::string		g_record_dir("frames");
+static unsigned int		g_record_games = 1;	// ppm visual records only the first games, each game is ~100 MB of frames
+static unsigned int		g_grid_size	= 1;
+static LiveView			g_live_view	= LV_NONE;
+static unsigned int		g_live_period = 5;
+static bool				g_count_allocs = false;
+static bool				g_print_latency = false;
+static std::string		g_analyze_file;
+static unsigned int		g_move_ms = 0;			// deadline of each algo decision, 0 means no deadline
+static unsigned long long	g_move_iterations = 0;	// iterations budget of each algo decision, 0 means no limit
+static unsigned int		g_move_limit_ms = 0;	// latency limit of each algo decision enforced by the engine
+#define MAX_SALVO_SHOTS 16
+static unsigned int		g_salvo = 1;			// shots per turn, all of them are chosen before their results are known
+#define DISTILL_MIN_SEEN 2
+static std::string		g_distill_file;			// table of the algo decisions to make for the distilled algo
+
+static thread_local unsigned int g_board = 0; // board of SDL visual (in grid view) which is fed by current game thread
+
+static std::atomic<unsigned int> g_recorded_games(0); // id of the next game recorded by ppm visual
+
+// Heap allocations of all games (with --count-allocs)
+static std::atomic<unsigned long long> g_game_allocs(0);		// whole game including placement and algo creation
+static std::atomic<unsigned long long> g_decision_allocs(0);	// algo decisions only (get_next_shot)
+
+// Latency of algo decisions, decisions which have finished after the deadline (--move-ms). Decisions are timed
+// only if it is needed by options; each game thread fills its own stats, they are merged when it finishes.
+struct MoveStats {
+	LatencyHistogram	_latency;
+	unsigned long long	_late_moves;
+
+	MoveStats()
+		: _late_moves(0)
+	{ }
+};
+static MoveStats					g_move_stats;
+static std::mutex					g_move_stats_mutex;
+static thread_local MoveStats*		g_thread_move_stats = NULL;
+
+// Watchdog of decision latency (--move-limit-ms): game threads publish the start of their current decision,
+// the run is terminated when some decision is over the limit even if the algo never returns
+#define MAX_WATCHED_THREADS 256
+static std::atomic<long long>		g_move_starts[MAX_WATCHED_THREADS];	// in ns of steady clock, 0 when not deciding
+static std::atomic<unsigned int>	g_watched_threads(0);
+static thread_local unsigned int	g_watch_slot = MAX_WATCHED_THREADS + 1;	// not assigned yet
+
+// Decisions of the teacher algo (--distill) are collected by each game thread and merged when it finishes
+static DistillCollector						g_distill;
+static std::mutex							g_distill_mutex;
+static thread_local DistillCollector*		g_thread_distill = NULL;
 
 static RandomPlacement			g_rp;
 static EclipsedPlacement		g_ep;
@@ -41,8 +106,12 @@ static FieldMaskAlgo			g_fma(g_dummy_gdata);
 static EclipsedAlgo				g_ea(g_dummy_gdata);
 static DummyAlgo				g_da(g_dummy_gdata);
 static MixedAlgo				g_ma(g_dummy_gdata);
+static MonteCarloAlgo			g_mca(g_dummy_gdata);
+static ExactAlgo				g_xa(g_dummy_gdata);
+static LookaheadAlgo			g_la(g_dummy_gdata);
+static DistilledAlgo			g_dsa(g_dummy_gdata);
 static std::string				g_algo(g_ma.get_algo_name());
-static DSBAlgoApi* const		g_algo_repo[] = {&g_ra, &g_fma, &g_ea, &g_da, &g_ma};
+static DSBAlgoApi* const		g_algo_repo[] = {&g_ra, &g_fma, &g_ea, &g_da, &g_ma, &g_mca, &g_xa, &g_la, &g_dsa};
 
 static std::string				g_custom_params;
 
@@ -60,6 +129,23 @@ static int print_usage(char* argv0)
 		"Not applicable for none/console_short visualization. (default=" << g_delay << ")\n";
 	std::cout << "\t--seed|-s <seed>              : apply specified seed for random() algorithm before start\n";
 	std::cout << "\t--key-pause|-k                : make pause until keypress to show each decision step\n";
+	std::cout << "\t--count-allocs                : count heap allocations made by games and by algo decisions\n";
+	std::cout << "\t--latency                     : print percentiles of algo decision latency (also printed with --move-ms/--move-limit-ms)\n";
+	std::cout << "\t--move-ms <ms>                : deadline of each algo decision, algo returns its best shot so far (no deadline by default)\n";
+	std::cout << "\t--move-iterations <n>         : iterations budget of each algo decision in units of the algo (no limit by default)\n";
+	std::cout << "\t--move-limit-ms <ms>          : terminate the run if any algo decision takes longer (no limit by default)\n";
+	std::cout << "\t--salvo <k>                   : salvo mode, algo fires up to k shots per turn, 1.." << MAX_SALVO_SHOTS <<
+		" (default=" << g_salvo << ")\n";
+	std::cout << "\t--cpu-level <cpu_level>       : force SIMD kernels of specified level for testing (default=" <<
+		get_cpu_level_name(get_cpu_detected_level()) << ", detected)\n";
+	std::cout << "\t--grid|-g <size>              : show grid of size x size boards played in parallel by sdl_opengl visual (default=" << g_grid_size << ")\n";
+	std::cout << "\t--live-view|-l <live_view>    : show games sampled from the silent run and live statistics (none by default)\n";
+	std::cout << "\t--live-period <seconds>       : sample one game of the silent run for the live view each <seconds> (default=" << g_live_period << ")\n";
+	std::cout << "\t--record-dir|-r <dir>         : directory to write frames of ppm visualization to (default=" << g_record_dir << ")\n";
+	std::cout << "\t--record-games <n>            : amount of games recorded by ppm visualization, the rest games are played silently (default=" <<
+		g_record_games << ")\n";
+	std::cout << "\t--analyze <file>              : print exact hit probabilities of the position from the file and exit\n";
+	std::cout << "\t--distill <file>              : save decisions of the algo to the table for the distilled algo (no salvo)\n";
 	std::cout << "\n";
 
 	std::cout << "Avaliable algo_names: ";
@@ -72,8 +158,10 @@ static int print_usage(char* argv0)
 		std::cout << g_placement_repo[--i]->get_placement_name();
 		std::cout << ( (i>0) ? ", " : "\n");
 	}
-	std::cout << "Available visual_names: none, console_full, console_short, sdl_opengl\n";
+	std::cout << "Available visual_names: none, console_full, console_short, console_ansi, sdl_opengl, ppm\n";
 	std::cout << "Available visual_types: combined, split, raw\n";
+	std::cout << "Available live_views: console, sdl_opengl\n";
+	std::cout << "Available cpu_levels: portable, sse2, avx2, avx512 (up to the detected one)\n";
 
 	// ----------------------------------------------------------------------------------
 	std::cout << "Custom params for algos:\n";
@@ -113,6 +201,23 @@ static bool parse_args(int argc, char* argv[])
 
 		if (arg == "--key-pause" || arg == "-k") {
 			g_key_pause = true;
+		} else if (arg == "--count-allocs") {
+			g_count_allocs = true;
+		} else if (arg == "--latency") {
+			g_print_latency = true;
+		} else if (arg == "--cpu-level") {
+			NEED_2ND_PARAM("--cpu-level")
+			std::string v(argv[++i]);
+			CpuLevel level;
+			if (!get_cpu_level_by_name(v, level)) {
+				std::cout << "Unsupported cpu level: " << v << '\n';
+				return false;
+			}
+			if (!set_cpu_level(level)) {
+				std::cout << "CPU level " << v << " is not supported by this CPU (detected " <<
+					get_cpu_level_name(get_cpu_detected_level()) << ")\n";
+				return false;
+			}
 		} else if (arg == "--algo" || arg == "-a") {
 			NEED_2ND_PARAM("--algo")
 			g_algo = argv[++i];
@@ -158,8 +263,12 @@ static bool parse_args(int argc, char* argv[])
 				g_visual = VE_CONSOLE_FULL;
 			} else if (v == "console_short") {
 				g_visual = VE_CONSOLE_SHORT;
+			} else if (v == "console_ansi") {
+				g_visual = VE_CONSOLE_ANSI;
 			} else if (v == "sdl_opengl") {
 				g_visual = VE_SDL_OPENGL;
+			} else if (v == "ppm") {
+				g_visual = VE_PPM;
 			} else {
 				std::cout << "Unsupported visual: " << v << '\n';
 				return false;
@@ -181,6 +290,71 @@ static bool parse_args(int argc, char* argv[])
 			if (delay >= 0) {
 				g_delay = static_cast<unsigned int>(delay);
 			}
+		} else if (arg == "--grid" || arg == "-g") {
+			NEED_2ND_PARAM("--grid")
+			int grid_size = atoi(argv[++i]);
+			if (grid_size < 1 || grid_size > 16) {
+				std::cout << "Grid size must be in range 1..16\n";
+				return false;
+			}
+			g_grid_size = static_cast<unsigned int>(grid_size);
+		} else if (arg == "--live-view" || arg == "-l") {
+			NEED_2ND_PARAM("--live-view")
+			std::string v(argv[++i]);
+			if (v == "console") {
+				g_live_view = LV_CONSOLE;
+			} else if (v == "sdl_opengl") {
+				g_live_view = LV_SDL_OPENGL;
+			} else {
+				std::cout << "Unsupported live view: " << v << '\n';
+				return false;
+			}
+		} else if (arg == "--live-period") {
+			NEED_2ND_PARAM("--live-period")
+			int period = atoi(argv[++i]);
+			if (period > 0) {
+				g_live_period = static_cast<unsigned int>(period);
+			}
+		} else if (arg == "--record-dir" || arg == "-r") {
+			NEED_2ND_PARAM("--record-dir")
+			g_record_dir = argv[++i];
+		} else if (arg == "--record-games") {
+			NEED_2ND_PARAM("--record-games")
+			int games = atoi(argv[++i]);
+			if (games < 1) {
+				std::cout << "Recorded games count must be positive\n";
+				return false;
+			}
+			g_record_games = static_cast<unsigned int>(games);
+		} else if (arg == "--move-ms") {
+			NEED_2ND_PARAM("--move-ms")
+			int ms = atoi(argv[++i]);
+			if (ms >= 0) {
+				g_move_ms = static_cast<unsigned int>(ms);
+			}
+		} else if (arg == "--move-iterations") {
+			NEED_2ND_PARAM("--move-iterations")
+			g_move_iterations = strtoull(argv[++i], NULL, 10);
+		} else if (arg == "--move-limit-ms") {
+			NEED_2ND_PARAM("--move-limit-ms")
+			int ms = atoi(argv[++i]);
+			if (ms >= 0) {
+				g_move_limit_ms = static_cast<unsigned int>(ms);
+			}
+		} else if (arg == "--salvo") {
+			NEED_2ND_PARAM("--salvo")
+			int salvo = atoi(argv[++i]);
+			if (salvo < 1 || salvo > MAX_SALVO_SHOTS) {
+				std::cout << "Salvo must be in range 1.." << MAX_SALVO_SHOTS << '\n';
+				return false;
+			}
+			g_salvo = static_cast<unsigned int>(salvo);
+		} else if (arg == "--analyze") {
+			NEED_2ND_PARAM("--analyze")
+			g_analyze_file = argv[++i];
+		} else if (arg == "--distill") {
+			NEED_2ND_PARAM("--distill")
+			g_distill_file = argv[++i];
 		} else if (arg == "--num" || arg == "-n") {
 			NEED_2ND_PARAM("--num")
 			g_num = atoi(argv[++i]);
@@ -195,87 +369,111 @@ static bool parse_args(int argc, char* argv[])
 	return true;
 }
 
-static ShotResult get_shot_res(const PlacementInfo& field, const FieldCoords& coords, DSBAlgoGenricData& gdata)
+// Boats of the game for O(1) shot result: boat of each cell and amount of not harmed cells of each boat
+struct GameBoats {
+	static constexpr uint8_t NO_BOAT = 0xFF;
+
+	uint8_t _boat_of_cell[FIELD_CELLS];
+	uint8_t _alive_cells[FLEET_BOATS_COUNT];
+	CellBitboard _cells[FLEET_BOATS_COUNT];
+
+	GameBoats(const FleetInfo& fleet)
+	{
+		memset(&_boat_of_cell[0], NO_BOAT, sizeof(_boat_of_cell));
+		for (unsigned int b=0; b<fleet._count; ++b) {
+			const BoatDescriptor& boat = fleet._boats[b];
+			_alive_cells[b] = boat._size;
+
+			CoordsSeq seq(boat._head, boat._is_horizontal, boat._size);
+			do {
+				const CellIdx cell(seq.cur());
+				_boat_of_cell[cell.index()] = b;
+				_cells[b].set(cell);
+				seq.next();
+			} while (!seq.is_outside());
+		}
+	}
+};
+
+static ShotResult get_shot_res(GameBoats& boats, const FieldCoords& coords, DSBAlgoGenricData& gdata)
 {
+	const CellIdx cell(coords);
+	const uint8_t boat = boats._boat_of_cell[cell.index()];
+
 	// If no boat part at this cell then you missed...
-	if (!field.get(coords)) {
-		gdata._field._info[coords._x][coords._y] = FPI_MISSED;
+	if (boat == GameBoats::NO_BOAT) {
+		gdata.apply_shot_result(cell, SR_MISSED);
 		return SR_MISSED;
 	}
 
-// shortcut macro to write less code
-#define RETURN_IF_ALIVE_BOARD_PART(X,Y)							\
-	if (!field.get(X, Y)) break;								\
-	if (gdata._field.get(X, Y) == FPI_UNKNOWN) {				\
-		gdata._field._info[coords._x][coords._y] = FPI_HARMED;	\
-		return SR_HARMED;							\
-	}
+	// Each cell of the boat can be harmed only once
+	assert(gdata._field.get(cell) == FPI_UNKNOWN);
+	assert(boats._alive_cells[boat] > 0);
 
-	unsigned int harmed_cells = 0;
-	// Try to search alive (non-harmed) boat part adjicent to harmed boat
-	// Trace all 4 directions until end-of-boat or until unknown cell is found
-	for (signed int x=((signed int) coords._x) - 1; x>((signed int)coords._x) - 4 && x>=0; --x) {
-		unsigned int x2 = (unsigned int) x;
-		RETURN_IF_ALIVE_BOARD_PART(x2, coords._y);
-		harmed_cells++;
-	}
-	for (signed int y=((signed int) coords._y) - 1; y>((signed int)coords._y) - 4 && y>=0; --y) {
-		unsigned int y2 = (unsigned int) y;
-		RETURN_IF_ALIVE_BOARD_PART(coords._x, y2);
-		harmed_cells++;
-	}
-	for (unsigned int x=coords._x + 1; x<coords._x+4 && x<FIELD_SIZE; ++x) {
-		RETURN_IF_ALIVE_BOARD_PART(x, coords._y);
-		harmed_cells++;
-	}
-	for (unsigned int y=coords._y + 1; y<coords._y+4 && y<FIELD_SIZE; ++y) {
-		RETURN_IF_ALIVE_BOARD_PART(coords._x, y);
-		harmed_cells++;
+	if (--boats._alive_cells[boat] > 0) {
+		gdata.apply_shot_result(cell, SR_HARMED);
+		return SR_HARMED;
 	}
 
-	// if no alive cell is found then this boat is completely dead...
-	gdata._field._info[coords._x][coords._y] = FPI_KILLED;
-	gdata._killed_boats++;
+	// if no alive cell remains then this boat is completely dead...
+	gdata.apply_shot_result(cell, SR_KILLED, boats._cells[boat]);
 
-	// Note - harmed_cells == size - 1 because focal cell (x,y) is not counted
-	gdata._killed_boats_of_size[harmed_cells]++;
-
-	int boats_count = 4 - harmed_cells;
-	if (gdata._killed_boats_of_size[harmed_cells] > boats_count) {
-		for (;;) ;
-	}
-	assert(gdata._killed_boats_of_size[harmed_cells] <= boats_count);
+	const unsigned int size = boats._cells[boat].count();
+	assert(gdata._killed_boats_of_size[size-1] <= 5 - size);
 
 	return SR_KILLED;
 }
 
-static void show_next_shot(const PlacementInfo& field, const DSBAlgoGenricData& gdata,
+static bool show_next_shot(const PlacementInfo& field, const DSBAlgoGenricData& gdata, DSBPpmVisual* ppm,
 	const ShotHints* shot_hints, const FieldCoords* coords = NULL, ShotResult sres = SR_MISSED)
 {
 	bool is_combined = (g_vtype == VT_COMBINED);
 
 	if (g_visual == VE_CONSOLE_FULL) {
 		dsb_console_visual_show_next_shot(field, gdata, is_combined, coords);
+	} else if (g_visual == VE_CONSOLE_ANSI) {
+		return dsb_console_ansi_visual_show_next_shot(field, gdata, is_combined, coords);
 	} else if (g_visual == VE_SDL_OPENGL) {
-		dsb_sdl_opengl_visual_show_next_shot(field, gdata, is_combined, shot_hints, coords, sres);
+		return dsb_sdl_opengl_visual_publish_frame(g_board, field, gdata, is_combined, shot_hints, coords, sres);
+	} else if (g_visual == VE_PPM && ppm != NULL) {
+		return ppm->show_next_shot(field, gdata, is_combined, shot_hints, coords, sres);
 	}
+	return true;
 }
 
-static void show_field(const PlacementInfo& field, const DSBAlgoGenricData& gdata, const ShotHints* shot_hints, ShotResult sres = SR_MISSED)
+static bool show_field(const PlacementInfo& field, const DSBAlgoGenricData& gdata, DSBPpmVisual* ppm,
+	const ShotHints* shot_hints, ShotResult sres = SR_MISSED)
 {
-	show_next_shot(field, gdata, shot_hints, NULL, sres);
+	return show_next_shot(field, gdata, ppm, shot_hints, NULL, sres);
+}
+
+// Visual engines which print the game progress to the console and make delays between steps
+inline bool is_interactive_visual()
+{
+	return (g_visual != VE_NONE && g_visual != VE_CONSOLE_SHORT && g_visual != VE_PPM);
+}
+
+// Game log of interactive visuals; SDL visual prints it in sync with the playback of published steps
+static bool visualization_log(const std::string& text)
+{
+	if (g_visual == VE_SDL_OPENGL) {
+		return dsb_sdl_opengl_visual_publish_text(g_board, text);
+	} else if (g_visual == VE_CONSOLE_ANSI) {
+		return dsb_console_ansi_visual_log(text);
+	}
+	std::cout << text << std::flush;
+	return true;
 }
 
 static bool visualization_delay_or_pause(unsigned int delay_factor)
 {
+	if (g_visual == VE_SDL_OPENGL) {
+		// Delays and pauses are handled by the render thread, the game does not wait here
+		return dsb_sdl_opengl_visual_publish_delay(g_board, delay_factor);
+	}
+
 	if (g_key_pause) {
-		if (g_visual == VE_SDL_OPENGL) {
-			if (!dsb_sdl_opengl_visual_pause()) {
-				return false;
-			}
-		} else {
-			// TODO
-		}
+		// TODO
 	} else {
 		SDL_Delay(g_delay*delay_factor);
 	}
@@ -284,106 +482,313 @@ static bool visualization_delay_or_pause(unsigned int delay_factor)
 
 constexpr unsigned int max_shots_per_game = FIELD_SIZE*FIELD_SIZE + 1;
 
-// Single game process
-static signed int play_one_game(const DSBAlgoApi* algo, const DSBPlacementApi* placement)
+// Step stream of the game sampled from the silent run for the live view
+struct SampledGame {
+	PlacementInfo	field;
+	FleetInfo		fleet;
+	unsigned int	shots;
+	FieldCoords		coords[max_shots_per_game];
+	ShotResult		sres[max_shots_per_game];
+};
+
+// Live view raises the request, the first game thread starting a new game takes it (so there is only one producer
+// at a time) and records this game; other games do not record anything and worker threads are not slowed down
+static std::atomic<bool>		g_sample_request(false);
+static SpscQueue<SampledGame, 4>	g_samples;
+
+// Visualization policy of the game loop for visual engine chosen by options (g_visual is checked at runtime)
+class RuntimeGameVisual {
+public:
+	RuntimeGameVisual()
+	{
+		if (g_visual == VE_PPM && g_recorded_games < g_record_games) {
+			const unsigned int game_id = g_recorded_games++;
+			if (game_id < g_record_games) {
+				_ppm.reset(new DSBPpmVisual(g_record_dir, game_id));
+			}
+		}
+	}
+
+	// Hints are collected only if visual engine can draw them
+	ShotHints* get_shot_hints()
+	{
+		if (g_visual == VE_SDL_OPENGL || _ppm) {
+			_shot_hints.clear();
+			return &_shot_hints;
+		}
+		return NULL;
+	}
+
+	// Field with hints from the algo and then with the chosen fire position
+	bool show_shot(const PlacementInfo& field, const DSBAlgoGenricData& gdata, const ShotHints* shot_hints,
+		const FieldCoords& coords)
+	{
+		if (is_interactive_visual()) {
+			std::string text = "(" + std::to_string(coords._x) + "," + std::to_string(coords._y) + ")";
+			text += (g_visual == VE_CONSOLE_FULL) ? "\n" : "\t-\t";
+			if (!visualization_log(text)) {
+				return false;
+			}
+		}
+
+		/* Visualization stage #1: show the field with hints from the algo, no fire position yet */
+		if (!show_field(field, gdata, _ppm.get(), shot_hints)) {
+			return false;
+		}
+		if (is_interactive_visual()) {
+			if (!visualization_delay_or_pause(1)) {
+				return false;
+			}
+		}
+
+		/* Visualization stage #2: show the filed with hints and with current chosen fire position */
+		if (!show_next_shot(field, gdata, _ppm.get(), shot_hints, &coords)) {
+			return false;
+		}
+		if (is_interactive_visual()) {
+			if (!visualization_delay_or_pause(2)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool show_shot_result(const PlacementInfo& field, const DSBAlgoGenricData& gdata, ShotResult sres)
+	{
+		if (is_interactive_visual()) {
+			bool is_logged = true;
+			switch (sres) {
+				case SR_MISSED: is_logged = visualization_log("missed...\n"); break;
+				case SR_HARMED: is_logged = visualization_log("Harmed!\n"); break;
+				case SR_KILLED: is_logged = visualization_log("KILLED!!!\n"); break;
+			}
+			if (!is_logged) {
+				return false;
+			}
+		}
+
+		/* Visualization stage #3: show result of fire, hints are not drawn as not vaild any more (obsolete) */
+		if (!show_field(field, gdata, _ppm.get(), /*shot_hints.get()*/ NULL, sres)) {
+			return false;
+		}
+
+		if (is_interactive_visual()) {
+			unsigned int delay_factor = (sres == SR_MISSED) ? 1 : 3;
+			if (!visualization_delay_or_pause(delay_factor)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool show_game_over(const PlacementInfo& field, const DSBAlgoGenricData& gdata)
+	{
+		if (g_visual == VE_CONSOLE_SHORT) {
+			dsb_console_visual_show_next_shot(field, gdata, NULL);
+		}
+		if (g_visual != VE_NONE && g_visual != VE_PPM) {
+			if (!visualization_log("Won with " + std::to_string(gdata._step_number) + " shots!\n")) {
+				return false;
+			}
+
+			const unsigned int game_over_factor = 20;
+			if (!visualization_delay_or_pause(game_over_factor)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+private:
+	std::unique_ptr<DSBPpmVisual>	_ppm;
+	ShotHints						_shot_hints;
+};
+
+// Visualization policy of the silent game: nothing to draw, so the game loop has no visual code at all
+class SilentGameVisual {
+public:
+	ShotHints* get_shot_hints() { return NULL; }
+
+	bool show_shot(const PlacementInfo&, const DSBAlgoGenricData&, const ShotHints*, const FieldCoords&) { return true; }
+	bool show_shot_result(const PlacementInfo&, const DSBAlgoGenricData&, ShotResult) { return true; }
+	bool show_game_over(const PlacementInfo&, const DSBAlgoGenricData&) { return true; }
+};
+
+static long long get_steady_ns(const std::chrono::steady_clock::time_point& t)
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+}
+
+static long long get_steady_ns()
 {
+	return get_steady_ns(std::chrono::steady_clock::now());
+}
+
+// Publishes the start of the decision of the current thread for the watchdog (0 when the decision is over)
+static void watch_move(long long start_ns)
+{
+	if (g_move_limit_ms == 0) return;
+
+	if (g_watch_slot > MAX_WATCHED_THREADS) {
+		const unsigned int slot = g_watched_threads++;
+		g_watch_slot = (slot < MAX_WATCHED_THREADS) ? slot : MAX_WATCHED_THREADS; // too many threads to watch
+	}
+	if (g_watch_slot < MAX_WATCHED_THREADS) {
+		g_move_starts[g_watch_slot] = start_ns;
+	}
+}
+
+// Shots of the salvo must be distinct cells which are not shot yet
+static bool is_valid_salvo(const DSBAlgoGenricData& gdata, const FieldCoords* salvo, unsigned int count)
+{
+	if (count == 0 || count > g_salvo) {
+		return false;
+	}
+	CellBitboard cells;
+	for (unsigned int s=0; s<count; ++s) {
+		const CellIdx cell(salvo[s]);
+		if (!gdata._obs._unknown.test(cell) || cells.test(cell)) {
+			return false;
+		}
+		cells.set(cell);
+	}
+	return true;
+}
+
+// Single game process, returns the amount of shots and the amount of turns (they differ in salvo mode)
+template<class GameVisual>
+static signed int play_one_game(const DSBAlgoApi* algo, const DSBPlacementApi* placement, unsigned int& turns)
+{
+	const unsigned long long game_allocs_start = get_thread_allocations();
+	unsigned long long decision_allocs = 0;
+
 	PlacementInfo field;
+	FleetInfo fleet;
 
 	std::unique_ptr<DSBPlacementApi> p(placement->clone());
-	if (!p->get_placement(field)) {
+	if (!p->get_placement(field, fleet)) {
 		std::cout << "Placement failure!" << std::endl;
 		return -1;
 	}
+	GameBoats boats(fleet);
 
 	DSBAlgoGenricData gdata;
 	std::unique_ptr<DSBAlgoApi> a(algo->clone(gdata));
 
+	GameVisual visual;
+
+	std::unique_ptr<SampledGame> sample;
+	if (g_sample_request.load(std::memory_order_relaxed)) {
+		bool is_requested = true;
+		if (g_sample_request.compare_exchange_strong(is_requested, false)) {
+			sample.reset(new SampledGame);
+			sample->field = field;
+			sample->fleet = fleet;
+			sample->shots = 0;
+		}
+	}
+
 	AlgoStepRes res;
+	turns = 0;
 	
 	// the worst game is to try each unknown cell
 	// if algorithm shoots twice per cell, it is considered ill-crafted
 	do {
 
-		FieldCoords coords;
-		std::unique_ptr<ShotHints> shot_hints;
-		if (g_visual == VE_SDL_OPENGL) {
-			shot_hints.reset(new ShotHints);
+		FieldCoords salvo[MAX_SALVO_SHOTS];
+		unsigned int salvo_count = 1;
+		ShotHints* shot_hints = (g_salvo == 1) ? visual.get_shot_hints() : NULL; // hints are made for one shot
+		const unsigned long long decision_allocs_start = get_thread_allocations();
+		std::chrono::steady_clock::time_point decision_start;
+		if (g_thread_move_stats != NULL) {
+			decision_start = std::chrono::steady_clock::now();
+		}
+		DecisionBudget budget;
+		if (g_move_ms > 0) {
+			budget._has_deadline = true;
+			budget._deadline = decision_start + std::chrono::milliseconds(g_move_ms);
+		}
+		budget._iterations = g_move_iterations;
+		if (g_move_limit_ms > 0) {
+			watch_move(get_steady_ns(decision_start));
+		}
+		if (g_salvo == 1) {
+			res = a->get_next_shot(salvo[0], shot_hints, budget);
+		} else {
+			res = a->get_next_shots(g_salvo, salvo, salvo_count, budget);
 		}
-		res = a->get_next_shot(coords, shot_hints.get());
+		if (g_move_limit_ms > 0) {
+			watch_move(0);
+		}
+		unsigned long long decision_us = 0;
+		if (g_thread_move_stats != NULL) {
+			decision_us = std::chrono::duration_cast<std::chrono::microseconds>(
+				std::chrono::steady_clock::now() - decision_start).count();
+		}
+		decision_allocs += get_thread_allocations() - decision_allocs_start;
 		if (res != ASR_OK) {
 			std::cout << "algo:" << algo->get_algo_name() << ": get_next_shot() returned err=" << (int) res << "\n";
 			return -2;
 		}
-
-		if (g_visual != VE_NONE && g_visual != VE_CONSOLE_SHORT) {
-			std::cout << "(" << coords._x << "," << coords._y << ")";
-			if (g_visual == VE_CONSOLE_FULL) {
-				std::cout << std::endl;
-			} else {
-				std::cout << "\t-\t" << std::flush;
-			}
+		if (!is_valid_salvo(gdata, salvo, salvo_count)) {
+			std::cout << "algo:" << algo->get_algo_name() << ": get_next_shots() returned invalid salvo of " << salvo_count <<
+				" shots\n";
+			return -2;
 		}
-
-		/* Visualization stage #1: show the field with hints from the algo, no fire position yet */
-		show_field(field, gdata, shot_hints.get());
-		if (g_visual != VE_NONE && g_visual != VE_CONSOLE_SHORT) {
-			if (!visualization_delay_or_pause(1)) {
-				return -1;
-			}
+		turns++;
+		if (g_thread_distill != NULL) {
+			g_thread_distill->add_decision(gdata, salvo[0]);
 		}
 
-		if (g_visual == VE_SDL_OPENGL) {
-			if (!dsb_sdl_opengl_visual_process_events()) {
-				return -1;
+		if (g_thread_move_stats != NULL) {
+			g_thread_move_stats->_latency.add(decision_us);
+			if (g_move_ms > 0 && decision_us > g_move_ms*1000ULL) {
+				g_thread_move_stats->_late_moves++;
+			}
+			if (g_move_limit_ms > 0 && decision_us > g_move_limit_ms*1000ULL) {
+				std::cout << "algo:" << algo->get_algo_name() << ": get_next_shot() took " << decision_us << " us, the limit is " <<
+					g_move_limit_ms << " ms\n";
+				return -4;
 			}
 		}
 
-		/* Visualization stage #2: show the filed with hints and with current chosen fire position */
-		show_next_shot(field, gdata, shot_hints.get(), &coords);
-
-		if (g_visual != VE_NONE && g_visual != VE_CONSOLE_SHORT) {
-			if (!visualization_delay_or_pause(2)) {
+		// results of the salvo are known after all its shots are chosen
+		for (unsigned int s=0; s<salvo_count && res != ASR_WON; ++s) {
+			const FieldCoords& coords = salvo[s];
+			if (!visual.show_shot(field, gdata, shot_hints, coords)) {
 				return -1;
 			}
-		}
 
-		ShotResult sres = get_shot_res(field, coords, gdata);
-		res = a->apply_shot_result(coords, sres);
+			ShotResult sres = get_shot_res(boats, coords, gdata);
+			res = a->apply_shot_result(coords, sres);
 
-		if (g_visual != VE_NONE && g_visual != VE_CONSOLE_SHORT) {
-			switch (sres) {
-				case SR_MISSED: std::cout << "missed...\n"; break;
-				case SR_HARMED: std::cout << "Harmed!\n"; break;
-				case SR_KILLED: std::cout << "KILLED!!!\n"; break;
+			if (sample) {
+				sample->coords[sample->shots] = coords;
+				sample->sres[sample->shots++] = sres;
 			}
-		}
-
-		/* Visualization stage #3: show result of fire, hints are not drawn as not vaild any more (obsolete) */
-		show_field(field, gdata, /*shot_hints.get()*/ NULL, sres);
 
-		if (res != ASR_WON) {
-			gdata._step_number++;
-		}
-
-		if (g_visual != VE_NONE && g_visual != VE_CONSOLE_SHORT) {
-			unsigned int delay_factor = (sres == SR_MISSED) ? 1 : 3;
-			if (!visualization_delay_or_pause(delay_factor)) {
+			if (!visual.show_shot_result(field, gdata, sres)) {
 				return -1;
 			}
+
+			if (res != ASR_WON) {
+				gdata._step_number++;
+			}
 		}
 	} while (res != ASR_WON && gdata._step_number < max_shots_per_game);
 
 	if (res == ASR_WON) {
-		if (g_visual == VE_CONSOLE_SHORT) {
-			dsb_console_visual_show_next_shot(field, gdata, NULL);
+		if (!visual.show_game_over(field, gdata)) {
+			return -1;
 		}
-		if (g_visual != VE_NONE) {
-			std::cout << "Won with " << gdata._step_number << " shots!\n";
 
-			const unsigned int game_over_factor = 20;
-			if (!visualization_delay_or_pause(game_over_factor)) {
-				return -1;
-			}
+		if (sample) {
+			g_samples.push(std::move(*sample)); // dropped if live view is too slow
+		}
+
+		if (g_count_allocs) {
+			g_game_allocs += get_thread_allocations() - game_allocs_start;
+			g_decision_allocs += decision_allocs;
 		}
 
 		return gdata._step_number;
@@ -394,7 +799,7 @@ static signed int play_one_game(const DSBAlgoApi* algo, const DSBPlacementApi* p
 // Wrapper to terminate and return/exit in one line
 static int term(int res, bool do_exit = false)
 {				
-	if (g_visual == VE_SDL_OPENGL) {
+	if (g_visual == VE_SDL_OPENGL || g_live_view == LV_SDL_OPENGL) {
 		dsb_sdl_opengl_visual_cleanup();
 	}
 	if (do_exit) {
@@ -403,15 +808,62 @@ static int term(int res, bool do_exit = false)
 	return res;
 }
 
+// Terminates the run when some decision is over the latency limit (--move-limit-ms), works while the object is alive
+class MoveWatchdog {
+public:
+	explicit MoveWatchdog(const std::string& algo_name)
+		: _algo_name(algo_name)
+		, _is_running(g_move_limit_ms > 0)
+	{
+		if (_is_running) {
+			_thread = std::thread(&MoveWatchdog::run, this);
+		}
+	}
+
+	~MoveWatchdog()
+	{
+		if (_thread.joinable()) {
+			_is_running = false;
+			_thread.join();
+		}
+	}
+
+private:
+	void run()
+	{
+		const long long limit_ns = g_move_limit_ms * 1000000LL;
+		const unsigned int period_ms = std::max(1U, std::min(g_move_limit_ms / 4, 100U));
+		while (_is_running) {
+			SDL_Delay(period_ms);
+			const long long now_ns = get_steady_ns();
+			const unsigned int threads = std::min(g_watched_threads.load(), (unsigned int) MAX_WATCHED_THREADS);
+			for (unsigned int i=0; i<threads; ++i) {
+				const long long start_ns = g_move_starts[i];
+				if (start_ns != 0 && now_ns - start_ns > limit_ns) {
+					std::cout << "algo:" << _algo_name << ": get_next_shot() is running longer than the limit of " <<
+						g_move_limit_ms << " ms\n";
+					(void) term(-4, /* do_exit = */ true);
+				}
+			}
+		}
+	}
+
+	std::string			_algo_name;
+	std::atomic<bool>	_is_running;
+	std::thread			_thread;
+};
+
 // Game statistics to be updated by parallel threads (in sharing mode)
 struct GameStats {
 	std::atomic<unsigned long long> games_count;
 	std::atomic<unsigned long long> total_shots;
+	std::atomic<unsigned long long> total_turns;
 	std::atomic<unsigned long long> shots_count[max_shots_per_game];
 
 	GameStats()
 		: games_count(0)
 		, total_shots(0)
+		, total_turns(0)
 	{
 		for (int i=0; i<max_shots_per_game; ++i) shots_count[i]=0;
 	}
@@ -420,14 +872,36 @@ struct GameStats {
 static void
 run_games_func(const DSBAlgoApi* algo, const DSBPlacementApi* placement, GameStats& stats, unsigned int thread_games_count)
 {
+	// Silent games are played by the game loop instantiated without any visual code
+	signed int (*play)(const DSBAlgoApi*, const DSBPlacementApi*, unsigned int&) =
+		(g_visual == VE_NONE) ? play_one_game<SilentGameVisual> : play_one_game<RuntimeGameVisual>;
+
+	std::unique_ptr<MoveStats> move_stats;
+	if (g_print_latency || g_move_ms > 0 || g_move_limit_ms > 0) {
+		move_stats.reset(new MoveStats);
+		g_thread_move_stats = move_stats.get();
+	}
+
+	std::unique_ptr<DistillCollector> distill;
+	if (!g_distill_file.empty()) {
+		distill.reset(new DistillCollector);
+		g_thread_distill = distill.get();
+	}
+
 	unsigned int my_thread_games_count = 0;
 	do {
-		signed int shots = play_one_game(algo, placement);
+		unsigned int turns;
+		signed int shots = play(algo, placement, turns);
+		if (shots <= 0 && g_visual == VE_SDL_OPENGL && dsb_sdl_opengl_visual_is_quit()) {
+			// User has closed the window, render thread is responsible for termination
+			return;
+		}
 		if (shots <= 0) {
 			// We are in multi-threaded process, exit from one thread must terminate all the rest threads prematurely
 			(void) term(shots, /* do_exit = */ true);
 		}
 		stats.total_shots += (unsigned int) shots;
+		stats.total_turns += turns;
 
 		assert(shots <= max_shots_per_game);
 		stats.shots_count[shots]++;
@@ -435,15 +909,104 @@ run_games_func(const DSBAlgoApi* algo, const DSBPlacementApi* placement, GameSta
 		stats.games_count++;
 		my_thread_games_count++;
 	} while (my_thread_games_count < thread_games_count || thread_games_count == 0);
+
+	if (move_stats) {
+		g_thread_move_stats = NULL;
+		std::lock_guard<std::mutex> lock(g_move_stats_mutex);
+		g_move_stats._latency.merge(move_stats->_latency);
+		g_move_stats._late_moves += move_stats->_late_moves;
+	}
+	if (distill) {
+		g_thread_distill = NULL;
+		std::lock_guard<std::mutex> lock(g_distill_mutex);
+		g_distill.merge(*distill);
+	}
 	std::cout << "Thread has finished the work." << std::endl;
 }
 
+static void
+run_board_games_func(const DSBAlgoApi* algo, const DSBPlacementApi* placement, GameStats& stats, unsigned int games_count,
+	unsigned int board, std::atomic<unsigned int>& running_games)
+{
+	g_board = board;
+	run_games_func(algo, placement, stats, games_count);
+	running_games--;
+}
+
 inline void print_summary(const GameStats& stats)
 {
 	std::cout << "*** Played " << stats.games_count << " games with total shots_count=" << stats.total_shots <<
 		", \taverage=" << ((double)stats.total_shots)/stats.games_count << '\n';
 }
 
+// Compact histogram for the live view: bars are scaled to the most frequent shots count
+static void print_live_histogram(const GameStats& stats)
+{
+	unsigned long long max_count = 0;
+	for (unsigned int i=0; i < max_shots_per_game; i++) {
+		if (stats.shots_count[i] > max_count) max_count = stats.shots_count[i];
+	}
+	if (max_count == 0) return;
+
+	for (unsigned int i=0; i < max_shots_per_game; i++) {
+		unsigned long long count = stats.shots_count[i];
+		if (count > 0) {
+			std::cout << i << '\t' << std::string(count * 60 / max_count, '=') << "> " << count << '\n';
+		}
+	}
+	print_summary(stats);
+}
+
+// Replays the sampled game: step by step in SDL window or the final field in console
+static bool show_sampled_game(const SampledGame& sample)
+{
+	bool is_combined = (g_vtype == VT_COMBINED);
+	DSBAlgoGenricData gdata;
+	GameBoats boats(sample.fleet);
+	for (unsigned int i=0; i<sample.shots; ++i) {
+		if (g_live_view == LV_SDL_OPENGL) {
+			if (!dsb_sdl_opengl_visual_publish_frame(0, sample.field, gdata, is_combined, NULL, &sample.coords[i]) ||
+				!dsb_sdl_opengl_visual_publish_delay(0, 1)) {
+				return false;
+			}
+		}
+		ShotResult sres = get_shot_res(boats, sample.coords[i], gdata);
+		assert(sres == sample.sres[i]);
+		if (g_live_view == LV_SDL_OPENGL) {
+			if (!dsb_sdl_opengl_visual_publish_frame(0, sample.field, gdata, is_combined, NULL, NULL, sres) ||
+				!dsb_sdl_opengl_visual_publish_delay(0, (sres == SR_MISSED) ? 1 : 3)) {
+				return false;
+			}
+		}
+	}
+	if (g_live_view == LV_CONSOLE) {
+		dsb_console_visual_show_next_shot(sample.field, gdata, is_combined);
+	}
+	std::cout << "Sampled game won with " << sample.shots << " shots\n";
+	return true;
+}
+
+// Live view of the silent run: samples one game each live period and shows it with the statistics collected so far
+static void
+live_view_func(GameStats& stats, const std::atomic<unsigned int>& running_workers, std::atomic<unsigned int>& running)
+{
+	SampledGame sample;
+	while (running_workers > 0) {
+		for (unsigned int ms = 0; ms < g_live_period*1000 && running_workers > 0; ms += 100) {
+			SDL_Delay(100);
+		}
+		g_sample_request = true;
+		while (!g_samples.pop(sample) && running_workers > 0) {
+			SDL_Delay(10);
+		}
+		if (running_workers == 0) break;
+
+		if (!show_sampled_game(sample)) break;
+		print_live_histogram(stats);
+	}
+	running--;
+}
+
 // entry point
 int main(int argc, char* argv[])
 {
@@ -453,6 +1016,10 @@ int main(int argc, char* argv[])
 		return print_usage(argv[0]);
 	}
 
+	if (!g_analyze_file.empty()) {
+		return dsb_analyze_position(g_analyze_file) ? 0 : -1;
+	}
+
 	//---------------------------------------------------------------------------------------
 	DSBAlgoApi*			algo		= NULL; // those pointers will refer to global objects, don't need to be released
 	DSBPlacementApi*	placement	= NULL;
@@ -473,8 +1040,10 @@ int main(int argc, char* argv[])
 	}
 	assert(placement != NULL);	// validated by parse_args via g_placement_repo
 
-	if (g_visual == VE_NONE) {
+	if (g_visual == VE_NONE || g_visual == VE_PPM) {
 		std::cout << "Using placement=" << placement->get_placement_name() << " and algo=" << algo->get_algo_name() << std::endl;
+		std::cout << "Using SIMD kernels of cpu level=" << get_cpu_level_name(get_cpu_level()) <<
+			" (detected " << get_cpu_level_name(get_cpu_detected_level()) << ")" << std::endl;
 	}
 
 	// In SDL_OpenGL mode placement and algo are printed in the title of the window;
@@ -490,20 +1059,36 @@ int main(int argc, char* argv[])
 		return -1;
 	}
 
+	if (!g_distill_file.empty() && (g_salvo > 1 || g_num == 0)) {
+		std::cout << "Distillation needs single shot turns and a limited amount of games" << std::endl;
+		return -1;
+	}
+
 	//---------------------------------------------------------------------------------------
 	srandom(g_seed);
 	if (g_visual == VE_SDL_OPENGL) {
-		if (!dsb_sdl_opengl_visual_init(placement->get_placement_name(), algo->get_algo_name())) {
+		if (!dsb_sdl_opengl_visual_init(placement->get_placement_name(), algo->get_algo_name(), g_grid_size)) {
 			return -1;
 		}
 	} else if (g_visual == VE_NONE) {
 		std::cout << "Playing " << g_num << " games in silent mode..." << std::endl;
+		if (g_live_view == LV_SDL_OPENGL &&
+			!dsb_sdl_opengl_visual_init(placement->get_placement_name(), algo->get_algo_name())) {
+			return -1;
+		}
+	} else if (g_visual == VE_PPM) {
+		if (!DSBPpmVisual::prepare_dir(g_record_dir)) {
+			return -1;
+		}
+		std::cout << "Recording " << g_record_games << " of " << g_num << " games to " << g_record_dir << "/..." << std::endl;
 	}
 	//---------------------------------------------------------------------------------------
 	// Main flow
 
+	MoveWatchdog watchdog(algo->get_algo_name());
 	GameStats stats;
-	if (g_visual == VE_NONE && g_num != 0) {
+	// Headless recording has no delays and no shared output, so it is parallelized in the same way as silent mode
+	if (g_visual == VE_NONE || (g_visual == VE_PPM && g_num != 0)) {
 		// Try to use multy-threading
 		unsigned int threads_num = std::thread::hardware_concurrency();
 		if (threads_num == 0) {
@@ -512,24 +1097,62 @@ int main(int argc, char* argv[])
 		} else {
 			if (threads_num > 1) {
 				std::cout << "Using multi-threading for silent mode, detected " << threads_num << " CPUs" << std::endl;
-				if (g_num < threads_num) {
+				if (g_num < threads_num && g_num != 0) {
 					// We have more CPUs than games requested, no need to load all CPUs ;-)
 					threads_num = g_num;
 				}
 			}
 		}
 		std::vector<std::thread> threads;
+		std::atomic<unsigned int> running_workers(threads_num);
 		unsigned int run_games = 0;
 		for (unsigned int i = threads_num; i--; ) {
 			// The last thread can run more games than others (games count might be not the multiple of CPUs count)
 			unsigned int this_thread_games_count = (i==0) ? (g_num - run_games) : (g_num / threads_num);
 			// std::cout << "Running thread for " << this_thread_games_count << " games..." << std::endl;
-			threads.push_back(std::thread(run_games_func, algo, placement, std::ref(stats), this_thread_games_count));
+			threads.push_back(std::thread(run_board_games_func, algo, placement, std::ref(stats), this_thread_games_count,
+				0, std::ref(running_workers)));
 			run_games += this_thread_games_count;
 		}
 		assert(run_games == g_num); // Just to be on the safe side - we asked to run all games we wanted
 
+		if (g_live_view == LV_CONSOLE) {
+			std::atomic<unsigned int> running_viewers(1);
+			live_view_func(stats, running_workers, running_viewers);
+		} else if (g_live_view == LV_SDL_OPENGL) {
+			// SDL window is owned by the current thread, sampled games are published by the viewer thread
+			std::atomic<unsigned int> running_viewers(1);
+			std::thread viewer(live_view_func, std::ref(stats), std::cref(running_workers), std::ref(running_viewers));
+			bool is_played = dsb_sdl_opengl_visual_run(g_delay, g_key_pause, running_viewers);
+			viewer.join();
+			if (!is_played) {
+				return term(-1, /* do_exit = */ true); // do not wait for the rest of the silent run
+			}
+		}
+
 		for (auto& th : threads) th.join(); // Wait for all threads to finish
+	} else if (g_visual == VE_SDL_OPENGL) {
+		// Games run in their own threads (one per board) and publish the steps; current thread owns the window
+		// and plays them back, so pause/speed/step controls of the playback never stall the algo
+		// Each board plays at least one game (0 games would mean endless play)
+		unsigned int boards = g_grid_size * g_grid_size;
+		if (g_num != 0 && g_num < boards) {
+			boards = g_num;
+		}
+		std::atomic<unsigned int> running_games(boards);
+		std::vector<std::thread> threads;
+		unsigned int run_games = 0;
+		for (unsigned int i = boards; i--; ) {
+			unsigned int this_board_games_count = (i==0) ? (g_num - run_games) : (g_num / boards);
+			threads.push_back(std::thread(run_board_games_func, algo, placement, std::ref(stats), this_board_games_count,
+				i, std::ref(running_games)));
+			run_games += this_board_games_count;
+		}
+		bool is_played = dsb_sdl_opengl_visual_run(g_delay, g_key_pause, running_games);
+		for (auto& th : threads) th.join();
+		if (!is_played) {
+			return term(-1);
+		}
 	} else {
 		// Do not use multithreading, run everything in current thread directly
 		run_games_func(algo, placement, stats, g_num);
@@ -551,5 +1174,37 @@ int main(int argc, char* argv[])
 	}
 	print_summary(stats);
 
+	if (g_count_allocs) {
+		std::cout << "*** Heap allocations: " << ((double)g_game_allocs)/stats.games_count << " per game, " <<
+			g_decision_allocs << " in algo decisions of all games\n";
+	}
+
+	if (g_salvo > 1) {
+		std::cout << "*** Salvo of " << g_salvo << " shots: total turns=" << stats.total_turns << ", turns per game=" <<
+			((double)stats.total_turns)/stats.games_count << '\n';
+	}
+
+	const LatencyHistogram& latency = g_move_stats._latency;
+	if (latency.get_count() > 0) {
+		std::cout << "*** Decision latency of algo=" << algo->get_algo_name() << ": p50=" << latency.get_percentile(50) <<
+			"us, p90=" << latency.get_percentile(90) << "us, p99=" << latency.get_percentile(99) <<
+			"us, p99.9=" << latency.get_percentile(99.9) << "us, max=" << latency.get_max() <<
+			"us over " << latency.get_count() << " decisions";
+		if (g_move_ms > 0) {
+			std::cout << ", " << g_move_stats._late_moves << " after the deadline of " << g_move_ms << " ms";
+		}
+		std::cout << '\n';
+	}
+
+	if (!g_distill_file.empty()) {
+		const signed long long features = g_distill.save(g_distill_file, DISTILL_MIN_SEEN);
+		if (features < 0) {
+			std::cout << "Cannot save distilled table to " << g_distill_file << std::endl;
+			return term(-1);
+		}
+		std::cout << "*** Distilled " << g_distill.get_decisions() << " decisions of algo=" << algo->get_algo_name() <<
+			" into " << features << " features of table " << g_distill_file << '\n';
+	}
+
 	return term(0);
 }
@@ -0,0 +1,134 @@
+#include <fstream>	// for std::ifstream
+#include <iostream>	// for std::cout
+#include <iomanip>	// for std::setw()
+
+#include "common/all.h"
+#include "algo/api/dsb_algo_api.h"
+#include "algo/exact_algo/fleet_counter.h"
+#include "dsb_analysis.h"
+
+// Enough for the empty field, so any position is counted exactly
+#define ANALYSIS_MAX_STATES (1U << 22)
+
+static bool load_position(const std::string& path, char (&cells)[FIELD_SIZE][FIELD_SIZE])
+{
+	std::ifstream file(path.c_str());
+	if (!file) {
+		std::cout << "Cannot open position file " << path << std::endl;
+		return false;
+	}
+
+	unsigned int y = 0;
+	std::string line;
+	while (std::getline(file, line)) {
+		if (line.empty() || line[0] == '#') continue;
+		if (y == FIELD_SIZE || line.size() < FIELD_SIZE) {
+			std::cout << "Position must have " << FIELD_SIZE << " lines of " << FIELD_SIZE << " cells" << std::endl;
+			return false;
+		}
+		for (unsigned int x=0; x<FIELD_SIZE; ++x) {
+			const char c = line[x];
+			if (c != '-' && c != '.' && c != 'x' && c != 'X') {
+				std::cout << "Unexpected cell '" << c << "' at (" << x << ',' << y << ')' << std::endl;
+				return false;
+			}
+			cells[y][x] = c;
+		}
+		++y;
+	}
+	if (y != FIELD_SIZE) {
+		std::cout << "Position must have " << FIELD_SIZE << " lines of " << FIELD_SIZE << " cells" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+// Killed boat which contains the cell: its cells go in one row or in one column
+static CellBitboard get_killed_boat(const char (&cells)[FIELD_SIZE][FIELD_SIZE], unsigned int x, unsigned int y)
+{
+	CellBitboard boat;
+	bool is_horizontal = (x+1 < FIELD_SIZE && cells[y][x+1] == 'X');
+	do {
+		boat.set(CellIdx(x, y));
+		is_horizontal ? ++x : ++y;
+	} while (x < FIELD_SIZE && y < FIELD_SIZE && cells[y][x] == 'X');
+	return boat;
+}
+
+static bool apply_position(const char (&cells)[FIELD_SIZE][FIELD_SIZE], DSBAlgoGenricData& gdata)
+{
+	CellBitboard killed;
+	for (unsigned int y=0; y<FIELD_SIZE; ++y) {
+		for (unsigned int x=0; x<FIELD_SIZE; ++x) {
+			const CellIdx cell(x, y);
+			if (cells[y][x] == '.') {
+				gdata.apply_shot_result(cell, SR_MISSED);
+			} else if (cells[y][x] == 'x') {
+				gdata.apply_shot_result(cell, SR_HARMED);
+			} else if (cells[y][x] == 'X' && !killed.test(cell)) {
+				const CellBitboard boat = get_killed_boat(cells, x, y);
+				const unsigned int size = boat.count();
+				if (size > 4 || gdata._killed_boats_of_size[size-1] == 5 - size) {
+					std::cout << "Unexpected killed boat of size " << size << " at (" << x << ',' << y << ')' << std::endl;
+					return false;
+				}
+				if (!(dilate8(boat) & killed).empty()) {
+					std::cout << "Killed boats touch each other at (" << x << ',' << y << ')' << std::endl;
+					return false;
+				}
+				killed |= boat;
+
+				// the last shot kills the boat, other cells were harmed before
+				for (CellBitboard rest = boat; !rest.empty(); ) {
+					const CellIdx boat_cell = rest.first();
+					rest.reset(boat_cell);
+					gdata.apply_shot_result(boat_cell, rest.empty() ? SR_KILLED : SR_HARMED, boat);
+				}
+			}
+		}
+	}
+	return true;
+}
+
+bool dsb_analyze_position(const std::string& path)
+{
+	char cells[FIELD_SIZE][FIELD_SIZE];
+	DSBAlgoGenricData gdata;
+	if (!load_position(path, cells) || !apply_position(cells, gdata)) {
+		return false;
+	}
+
+	FleetCounter counter(ANALYSIS_MAX_STATES);
+	FleetCounts counts;
+	if (!counter.count(gdata._obs, gdata._killed_boats_of_size, counts)) {
+		std::cout << "Position is too complex for counting (more than " << ANALYSIS_MAX_STATES << " states)" << std::endl;
+		return false;
+	}
+	std::cout << "Fleets consistent with the position: " << counts._total << " (search states: " <<
+		counter.get_states_count() << ")" << std::endl;
+	if (counts._total == 0) {
+		return true;
+	}
+
+	// hit probabilities in percents, shot cells are shown as in the position
+	CellIdx best;
+	std::cout << std::fixed << std::setprecision(1);
+	for (unsigned int y=0; y<FIELD_SIZE; ++y) {
+		for (unsigned int x=0; x<FIELD_SIZE; ++x) {
+			const CellIdx cell(x, y);
+			if (cells[y][x] != '-') {
+				std::cout << std::setw(6) << cells[y][x];
+				continue;
+			}
+			std::cout << std::setw(6) << static_cast<double>(counts._cells[cell.index()]) * 100 / counts._total;
+			if (counts._cells[cell.index()] > (best.is_none() ? 0 : counts._cells[best.index()])) {
+				best = cell;
+			}
+		}
+		std::cout << '\n';
+	}
+	if (!best.is_none()) {
+		std::cout << "The best shot: (" << best.x() << ',' << best.y() << ')' << std::endl;
+	}
+	return true;
+}
@@ -0,0 +1,11 @@
+#ifndef __DSB_ANALYSIS_H__
+#define __DSB_ANALYSIS_H__
+
+#include <string>	// for std::string
+
+// Offline analysis of the position loaded from the file: exact hit probability of each cell.
+// The file has FIELD_SIZE lines of FIELD_SIZE cells: '-' is unknown, '.' missed, 'x' harmed, 'X' killed;
+// lines starting with '#' are comments. Returns false if the file can't be loaded.
+bool dsb_analyze_position(const std::string& path);
+
+#endif // __DSB_ANALYSIS_H__
@@ -0,0 +1,167 @@
+#include <cstring>	// for memcpy(), memcmp()
+#include <algorithm>	// for std::min
+#include <cerrno>	// for errno
+#include <cassert>	// for assert()
+#include <iostream>	// for std::cout
+
+#include <unistd.h>	// for write()
+
+#include "common/all.h"
+#include "algo/api/dsb_algo_api.h"
+#include "dsb_console_ansi_visual.h"
+
+// Screen layout (rows/columns are 1-based as in ANSI escape sequences)
+constexpr unsigned int FIELD_ROW	= 2;				// the first row of cells, row 1 is the top border
+constexpr unsigned int FIELD_COL	= 2;				// the first column of cells, column 1 is the left border
+constexpr unsigned int STATUS_ROW	= FIELD_SIZE + 3;	// game log line below the bottom border
+constexpr unsigned int PARK_ROW		= STATUS_ROW + 1;	// cursor is left here, so other output goes below the field
+constexpr unsigned int STATUS_MAX	= 80;				// longer log lines are truncated
+
+// Worst case frame: screen clear, borders and every cell with its own cursor positioning, plus the status line
+constexpr size_t FRAME_BUF_SIZE = 4096;
+
+static char			g_buf[FRAME_BUF_SIZE];
+static size_t		g_buf_len	= 0;
+
+static char			g_shown[FIELD_SIZE][FIELD_SIZE][2];	// cells as they are on the screen now
+static bool			g_is_drawn	= false;				// screen is cleared and borders are drawn
+
+static std::string	g_status;
+static bool			g_is_status_complete = true;		// the next log text starts a new status line
+
+inline void buf_put(const char* s, size_t len)
+{
+	assert(g_buf_len + len <= FRAME_BUF_SIZE);
+	memcpy(&g_buf[g_buf_len], s, len);
+	g_buf_len += len;
+}
+
+inline void buf_put(const char* s)
+{
+	buf_put(s, strlen(s));
+}
+
+static void buf_put_uint(unsigned int v)
+{
+	char digits[10];
+	unsigned int n = 0;
+	do {
+		digits[n++] = '0' + v % 10;
+		v /= 10;
+	} while (v != 0);
+	while (n--) {
+		g_buf[g_buf_len++] = digits[n];
+	}
+}
+
+// ESC [ row ; col H
+static void buf_put_cursor(unsigned int row, unsigned int col)
+{
+	buf_put("\x1b[");
+	buf_put_uint(row);
+	buf_put(";", 1);
+	buf_put_uint(col);
+	buf_put("H", 1);
+}
+
+static bool buf_flush()
+{
+	buf_put_cursor(PARK_ROW, 1);
+
+	// Output of std::cout must not be reordered with our direct write()
+	std::cout.flush();
+
+	const char* p = g_buf;
+	size_t left = g_buf_len;
+	while (left > 0) {
+		ssize_t written = write(STDOUT_FILENO, p, left);
+		if (written < 0) {
+			if (errno == EINTR) continue;
+			return false;
+		}
+		p += written;
+		left -= written;
+	}
+	g_buf_len = 0;
+	return true;
+}
+
+static void buf_put_border(unsigned int row)
+{
+	buf_put_cursor(row, 1);
+	for (int i=0; i<FIELD_SIZE*2+2; ++i) {
+		buf_put("=", 1);
+	}
+}
+
+// Same symbols as dsb_console_visual_show_next_shot()
+static const char* get_cell_symbol(const PlacementInfo& field, const DSBAlgoGenricData& gdata,
+	bool is_combined, const FieldCoords* coords, unsigned int x, unsigned int y)
+{
+	if (coords != NULL && coords->_x == x && coords->_y == y) {
+		return "??";
+	} else if (gdata._field.get(x, y) == FPI_UNKNOWN) {
+		return (is_combined && field.get(x, y)) ? "**" : "  ";
+	} else if (gdata._field.get(x, y) == FPI_MISSED) {
+		return "..";
+	} else if (gdata._field.get(x, y) == FPI_HARMED) {
+		return "xx";
+	}
+	return "XX";
+}
+
+bool dsb_console_ansi_visual_show_next_shot(const PlacementInfo& field, const DSBAlgoGenricData& gdata,
+	bool is_combined, const FieldCoords* coords /* = NULL */)
+{
+	if (!g_is_drawn) {
+		buf_put("\x1b[2J");	// clear screen
+		buf_put_border(FIELD_ROW - 1);
+		for (unsigned int y=0; y<FIELD_SIZE; ++y) {
+			buf_put_cursor(FIELD_ROW + y, 1);
+			buf_put("|", 1);
+			buf_put_cursor(FIELD_ROW + y, FIELD_COL + FIELD_SIZE*2);
+			buf_put("|", 1);
+		}
+		buf_put_border(FIELD_ROW + FIELD_SIZE);
+		memset(g_shown, ' ', sizeof(g_shown));
+		for (unsigned int y=0; y<FIELD_SIZE; ++y) {
+			buf_put_cursor(FIELD_ROW + y, FIELD_COL);
+			buf_put(&g_shown[y][0][0], sizeof(g_shown[y]));
+		}
+		g_is_drawn = true;
+	}
+
+	// Redraw only changed cells; adjacent changed cells in a row share one cursor positioning
+	for (unsigned int y=0; y<FIELD_SIZE; ++y) {
+		bool is_cursor_here = false;
+		for (unsigned int x=0; x<FIELD_SIZE; ++x) {
+			const char* symbol = get_cell_symbol(field, gdata, is_combined, coords, x, y);
+			if (memcmp(g_shown[y][x], symbol, 2) == 0) {
+				is_cursor_here = false;
+				continue;
+			}
+			if (!is_cursor_here) {
+				buf_put_cursor(FIELD_ROW + y, FIELD_COL + x*2);
+				is_cursor_here = true;
+			}
+			buf_put(symbol, 2);
+			memcpy(g_shown[y][x], symbol, 2);
+		}
+	}
+
+	return buf_flush();
+}
+
+bool dsb_console_ansi_visual_log(const std::string& text)
+{
+	if (g_is_status_complete) {
+		g_status.clear();
+	}
+	g_is_status_complete = (!text.empty() && text.back() == '\n');
+	g_status.append(text, 0, g_is_status_complete ? text.length() - 1 : text.length());
+
+	buf_put_cursor(STATUS_ROW, 1);
+	buf_put(g_status.c_str(), std::min<size_t>(g_status.length(), STATUS_MAX));
+	buf_put("\x1b[K");	// erase the rest of the previous status
+	return buf_flush();
+}
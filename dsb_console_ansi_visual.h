@@ -0,0 +1,14 @@
+#ifndef __DSB_CONSOLE_ANSI_VISUAL_H__
+#define __DSB_CONSOLE_ANSI_VISUAL_H__
+
+#include <string>	// for std::string
+
+// ANSI terminal visual: the field is drawn once and then updated in place (only changed cells are redrawn
+// via cursor positioning), each frame is built in a preallocated buffer and written by a single write() call
+bool dsb_console_ansi_visual_show_next_shot(const PlacementInfo& field, const DSBAlgoGenricData& gdata,
+	bool is_combined, const FieldCoords* coords = NULL);
+
+// Game log goes to the status line below the field instead of scrolling the terminal
+bool dsb_console_ansi_visual_log(const std::string& text);
+
+#endif // __DSB_CONSOLE_ANSI_VISUAL_H__
@@ -0,0 +1,58 @@
+#include <algorithm>	// for std::sort
+#include <vector>		// for std::vector
+
+#include "algo/distilled_algo/distill_table.h"
+#include "dsb_distill.h"
+
+void DistillCollector::add_decision(const DSBAlgoGenricData& gdata, const FieldCoords& coords)
+{
+	const FieldObservation& obs = gdata._obs;
+	const CellBitboard free = DistillTable::get_free_cells(obs);
+	const CellIdx chosen(coords);
+	if (!obs._harmed.empty() || !free.test(chosen)) {
+		return;
+	}
+
+	const unsigned int max_alive_size = DistillTable::get_max_alive_size(gdata._killed_boats_of_size);
+	for (CellBitboard cells = free; !cells.empty(); ) {
+		const CellIdx cell = cells.first();
+		cells.reset(cell);
+
+		const DistillFeatures features(free, max_alive_size, cell);
+		for (unsigned int r=1; r<=DISTILL_MAX_RADIUS; ++r) {
+			Counts& counts = _counts[features.get_key(r)];	// zero initialized when the feature is new
+			counts._seen++;
+			if (cell == chosen) {
+				counts._chosen++;
+			}
+		}
+	}
+	_decisions++;
+}
+
+void DistillCollector::merge(const DistillCollector& other)
+{
+	for (auto it=other._counts.begin(); it != other._counts.end(); ++it) {
+		Counts& counts = _counts[it->first];
+		counts._chosen += it->second._chosen;
+		counts._seen += it->second._seen;
+	}
+	_decisions += other._decisions;
+}
+
+signed long long DistillCollector::save(const std::string& path, unsigned int min_seen) const
+{
+	std::vector<DistillEntry> entries;
+	for (auto it=_counts.begin(); it != _counts.end(); ++it) {
+		if (it->second._seen >= min_seen) {
+			entries.push_back(DistillEntry{ it->first, it->second._chosen, it->second._seen });
+		}
+	}
+	std::sort(entries.begin(), entries.end(),
+		[](const DistillEntry& a, const DistillEntry& b) { return a._key < b._key; });
+
+	if (!DistillTable::save(path, entries)) {
+		return -1;
+	}
+	return static_cast<signed long long>(entries.size());
+}
@@ -0,0 +1,37 @@
+#ifndef __DSB_DISTILL_H__
+#define __DSB_DISTILL_H__
+
+#include <cstdint>			// for uint64_t, uint32_t
+#include <string>			// for std::string
+#include <unordered_map>	// for std::unordered_map
+
+#include "algo/api/dsb_algo_api.h"	// for DSBAlgoGenricData
+
+// Collector of the teacher algo decisions (--distill): for each decision every free cell counts its feature
+// as seen and the chosen cell counts its feature as chosen. Saved table is loaded by the distilled algo.
+class DistillCollector {
+public:
+	DistillCollector()
+		: _decisions(0)
+	{ }
+
+	// Decisions of positions with a harmed boat are skipped, the distilled algo finishes harmed boats itself
+	void add_decision(const DSBAlgoGenricData& gdata, const FieldCoords& coords);
+	void merge(const DistillCollector& other);
+
+	// Features seen less than min_seen times are dropped as noise; returns the amount of saved features or -1
+	signed long long save(const std::string& path, unsigned int min_seen) const;
+
+	unsigned long long get_decisions() const { return _decisions; }
+
+private:
+	struct Counts {
+		uint32_t	_chosen;
+		uint32_t	_seen;
+	};
+
+	std::unordered_map<uint64_t, Counts>	_counts;
+	unsigned long long						_decisions;
+};
+
+#endif // __DSB_DISTILL_H__
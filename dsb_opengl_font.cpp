@@ -84,6 +84,18 @@ void dsb_opengl_init_raster_font()
 	make_raster_font();
 }
 
+// Raw glyph bitmap (DSB_OENGL_FONT_HEIGHT rows, the bottom row first, MSB is the left-most pixel)
+const unsigned char* dsb_opengl_get_glyph(char c)
+{
+	if (c >= 'A' && c <= 'Z') {
+		return g_letters[c - 'A'];
+	}
+	if (c >= '0' && c <= '9') {
+		return g_digits[c - '0'];
+	}
+	return g_space;
+}
+
 void dsb_opengl_print_string(const std::string& s)
 {
 	glPushAttrib(GL_LIST_BIT);
@@ -8,6 +8,7 @@
 
 void dsb_opengl_init_raster_font();
 void dsb_opengl_print_string(const std::string& s);
+const unsigned char* dsb_opengl_get_glyph(char c);
 
 
 #endif // __DSB_OPENGL_FONT_H__
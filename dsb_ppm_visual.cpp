@@ -0,0 +1,237 @@
+#include <iostream>		// for std::cout
+#include <cstdio>		// for fopen(), fwrite()
+#include <cstring>		// for strerror()
+#include <cerrno>		// for errno
+
+#include <sys/stat.h>	// for mkdir()
+
+#include "dsb_ppm_visual.h"
+#include "dsb_opengl_font.h"	// for dsb_opengl_get_glyph()
+#include "dsb_visual_common.h"
+
+constexpr signed int CELL_PX = 48;	// size of the cell including one grid line
+constexpr signed int GRID_PX = 2;	// width of grid lines
+constexpr signed int IMAGE_PX = FIELD_SIZE*CELL_PX + GRID_PX;
+
+DSBPpmVisual::DSBPpmVisual(const std::string& dir, unsigned int game_id)
+	: _dir(dir)
+	, _game_id(game_id)
+	, _frame(0)
+	, _pixels(IMAGE_PX*IMAGE_PX*3)
+{ }
+
+bool DSBPpmVisual::prepare_dir(const std::string& dir)
+{
+	if (mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST) {
+		std::cout << "Cannot create directory '" << dir << "': " << strerror(errno) << std::endl;
+		return false;
+	}
+	return true;
+}
+
+void DSBPpmVisual::put_pixel(signed int x, signed int y, Color c)
+{
+	if (x < 0 || y < 0 || x >= IMAGE_PX || y >= IMAGE_PX) return;
+
+	uint8_t* p = &_pixels[(y*IMAGE_PX + x)*3];
+	p[0] = c.r;
+	p[1] = c.g;
+	p[2] = c.b;
+}
+
+void DSBPpmVisual::fill_rect(signed int x, signed int y, signed int w, signed int h, Color c)
+{
+	for (signed int j=y; j<y+h; ++j) {
+		for (signed int i=x; i<x+w; ++i) {
+			put_pixel(i, j, c);
+		}
+	}
+}
+
+// Bresenham line, 2 pixels wide (the same look as glLineWidth in SDL visual)
+void DSBPpmVisual::draw_line(signed int x1, signed int y1, signed int x2, signed int y2, Color c)
+{
+	signed int dx = (x2 > x1) ? (x2 - x1) : (x1 - x2);
+	signed int dy = (y2 > y1) ? (y1 - y2) : (y2 - y1);
+	signed int sx = (x1 < x2) ? 1 : -1;
+	signed int sy = (y1 < y2) ? 1 : -1;
+	signed int err = dx + dy;
+
+	for (;;) {
+		fill_rect(x1, y1, 2, 2, c);
+		if (x1 == x2 && y1 == y2) break;
+		signed int e2 = 2*err;
+		if (e2 >= dy) {
+			err += dy;
+			x1 += sx;
+		}
+		if (e2 <= dx) {
+			err += dx;
+			y1 += sy;
+		}
+	}
+}
+
+void DSBPpmVisual::draw_circle(signed int cx, signed int cy, signed int r, Color c, bool is_filled)
+{
+	const signed int r_outer = r*r;
+	const signed int r_inner = (r-2)*(r-2);
+	for (signed int y=-r; y<=r; ++y) {
+		for (signed int x=-r; x<=r; ++x) {
+			signed int d = x*x + y*y;
+			if (d <= r_outer && (is_filled || d >= r_inner)) {
+				put_pixel(cx+x, cy+y, c);
+			}
+		}
+	}
+}
+
+void DSBPpmVisual::print_number_centered(signed int cx, signed int cy, unsigned int num, Color c)
+{
+	std::string s = std::to_string(num);
+
+	signed int x = cx - (DSB_OENGL_FONT_WIDTH * (signed int) s.length())/2;
+	signed int y = cy + DSB_OENGL_FONT_HEIGHT/2;	// glyph rows go from the bottom to the top
+	for (char ch : s) {
+		const unsigned char* glyph = dsb_opengl_get_glyph(ch);
+		for (signed int row=0; row<DSB_OENGL_FONT_HEIGHT; ++row) {
+			for (signed int col=0; col<DSB_OENGL_FONT_WIDTH; ++col) {
+				if (glyph[row] & (0x80 >> col)) {
+					put_pixel(x+col, y-row, c);
+				}
+			}
+		}
+		x += DSB_OENGL_FONT_WIDTH;
+	}
+}
+
+inline signed int cell_center(unsigned int v)
+{
+	return v*CELL_PX + GRID_PX + (CELL_PX-GRID_PX)/2;
+}
+
+void DSBPpmVisual::draw_bombed_square(unsigned int x, unsigned int y, int hint_color /* = -1 */)
+{
+	const signed int radius = CELL_PX*0.35f;
+	if (hint_color == -1) {
+		Color c = {255, 204, 204};
+		draw_circle(cell_center(x), cell_center(y), radius, c, /* is_filled = */ true);
+	} else if (hint_color >= 1 && hint_color <= 3) {
+		uint8_t v = ((3-hint_color) * 0.25f + 0.3f) * 255;
+		Color c = {v, v, 0};
+		draw_circle(cell_center(x), cell_center(y), radius, c, /* is_filled = */ false);
+	}
+}
+
+void DSBPpmVisual::draw_boat_square(unsigned int x, unsigned int y, bool is_killed, bool is_harmed)
+{
+	Color c = {25, 64, 25};
+	if (is_killed) {
+		c = Color{255, 102, 102};
+	} else if (is_harmed) {
+		c = Color{255, 178, 128};
+	}
+	fill_rect(x*CELL_PX + GRID_PX, y*CELL_PX + GRID_PX, CELL_PX-GRID_PX, CELL_PX-GRID_PX, c);
+}
+
+void DSBPpmVisual::draw_miss_square(unsigned int x, unsigned int y, bool is_prohibited)
+{
+	signed int cx = cell_center(x);
+	signed int cy = cell_center(y);
+
+	if (is_prohibited) {
+		const signed int d = CELL_PX*0.15f;
+		Color c = {255, 255, 255};
+		draw_line(cx-d, cy-d, cx+d, cy+d, c);
+		draw_line(cx-d, cy+d, cx+d, cy-d, c);
+	} else {
+		Color c = {255, 102, 102};
+		fill_rect(cx-3, cy-3, 6, 6, c);
+	}
+}
+
+bool DSBPpmVisual::write_frame()
+{
+	char name[64];
+	snprintf(name, sizeof(name), "/game%06u_%04u.ppm", _game_id, _frame++);
+	std::string path = _dir + name;
+
+	FILE* f = fopen(path.c_str(), "wb");
+	if (f == NULL) {
+		std::cout << "Cannot write frame '" << path << "': " << strerror(errno) << std::endl;
+		return false;
+	}
+	fprintf(f, "P6\n%d %d\n255\n", IMAGE_PX, IMAGE_PX);
+	bool is_ok = (fwrite(&_pixels[0], 1, _pixels.size(), f) == _pixels.size());
+	is_ok = (fclose(f) == 0) && is_ok;
+	return is_ok;
+}
+
+// Mirrors dsb_sdl_opengl_visual_show_next_shot() but draws into the memory buffer
+bool DSBPpmVisual::show_next_shot(const PlacementInfo& field, const DSBAlgoGenricData& gdata, bool is_combined,
+	const ShotHints* shot_hints, const FieldCoords* coords /* = NULL */, ShotResult sres /* = SR_MISSED */)
+{
+	Color bg = {0, 0, 0};
+	if (sres == SR_HARMED) {
+		bg.r = 77;	// constant blink color: random() must not be shared with the game flow
+	} else if (sres == SR_KILLED) {
+		bg.r = 153;
+	}
+	fill_rect(0, 0, IMAGE_PX, IMAGE_PX, bg);
+
+	// Draw a field FIELD_SIZE x FIELD_SIZE
+	Color grid = {255, 255, 255};
+	for (signed int i=0; i <= FIELD_SIZE; i++) {
+		fill_rect(i*CELL_PX, 0, GRID_PX, IMAGE_PX, grid);
+		fill_rect(0, i*CELL_PX, IMAGE_PX, GRID_PX, grid);
+	}
+
+	// Fill cells
+	for (signed int y=0; y<FIELD_SIZE; ++y) {
+		for (signed int x=0; x<FIELD_SIZE; ++x) {
+			bool is_ignore_hint = false;
+			if (coords != NULL && coords->_x == static_cast<unsigned int>(x) && coords->_y == static_cast<unsigned int>(y)) {
+				if (is_combined && field.get(x,y)) {
+					draw_boat_square(x, y, false, false);
+					is_ignore_hint = true;
+				}
+				draw_bombed_square(x, y);
+			} else if (gdata._field.get(x, y) == FPI_UNKNOWN) {
+				if (field.get(x,y)) {
+					if (is_combined) {
+						draw_boat_square(x, y, false, false);
+					}
+				} else {
+					if (check_if_near_killed_boat(gdata, x,y)) {
+						draw_miss_square(x, y, /* is_prohibited = */ true);
+						is_ignore_hint = true;
+					}
+				}
+			} else if (gdata._field.get(x, y) == FPI_MISSED) {
+				draw_miss_square(x, y, /* is_prohibited = */ false);
+				is_ignore_hint = true;
+			} else {
+				bool is_killed = check_if_boat_killed(gdata, x,y);
+				draw_boat_square(x, y, is_killed, !is_killed);
+				is_ignore_hint = true;
+			}
+
+			if (!is_ignore_hint && shot_hints != NULL) {
+				FieldCoords coord(x, y);
+				auto hint_it = shot_hints->find(coord);
+				if (hint_it != shot_hints->end()) {
+					if (hint_it->second.hint_flags & SH_COLORED) {
+						draw_bombed_square(x, y, hint_it->second.hint_color);
+					}
+
+					if (hint_it->second.hint_flags & SH_NUMBERED) {
+						Color c = {178, 255, 178};
+						print_number_centered(cell_center(x), cell_center(y), hint_it->second.hint_number, c);
+					}
+				}
+			}
+		}
+	}
+
+	return write_frame();
+}
@@ -0,0 +1,48 @@
+#ifndef __DSB_PPM_VISUAL_H__
+#define __DSB_PPM_VISUAL_H__
+
+#include <string>	// for std::string
+#include <vector>	// for std::vector
+#include <cstdint>	// for uint8_t
+
+#include "common/all.h"
+#include "algo/api/dsb_algo_api.h"
+
+// Headless (offscreen) visual: every frame is rasterized on CPU and written to a separate PPM file.
+// No display is needed and there are no delays, so several games can be recorded in parallel threads
+// (each thread has to use its own DSBPpmVisual object).
+class DSBPpmVisual {
+public:
+	DSBPpmVisual(const std::string& dir, unsigned int game_id);
+
+	bool show_next_shot(const PlacementInfo& field, const DSBAlgoGenricData& gdata, bool is_combined,
+		const ShotHints* shot_hints, const FieldCoords* coords = NULL, ShotResult sres = SR_MISSED);
+
+	static bool prepare_dir(const std::string& dir);
+
+private:
+	struct Color {
+		uint8_t r;
+		uint8_t g;
+		uint8_t b;
+	};
+
+	void put_pixel(signed int x, signed int y, Color c);
+	void fill_rect(signed int x, signed int y, signed int w, signed int h, Color c);
+	void draw_line(signed int x1, signed int y1, signed int x2, signed int y2, Color c);
+	void draw_circle(signed int cx, signed int cy, signed int r, Color c, bool is_filled);
+	void print_number_centered(signed int cx, signed int cy, unsigned int num, Color c);
+
+	void draw_bombed_square(unsigned int x, unsigned int y, int hint_color = -1);
+	void draw_boat_square(unsigned int x, unsigned int y, bool is_killed, bool is_harmed);
+	void draw_miss_square(unsigned int x, unsigned int y, bool is_prohibited);
+
+	bool write_frame();
+
+	std::string				_dir;
+	unsigned int			_game_id;
+	unsigned int			_frame;
+	std::vector<uint8_t>	_pixels;	// RGB triplets, row by row
+};
+
+#endif // __DSB_PPM_VISUAL_H__
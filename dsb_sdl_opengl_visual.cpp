@@ -1,6 +1,9 @@
 // C++ Headers
 #include <string>
 #include <iostream>
+#include <atomic>
+#include <vector>
+#include <memory>
 
 // OpenGL / glew Headers
 #define GL3_PROTOTYPES 1
@@ -10,8 +13,11 @@
 #include <SDL2/SDL.h>
 
 #include "common/all.h"
+#include "common/spsc_queue.h"
 #include "algo/api/dsb_algo_api.h"
+#include "dsb_sdl_opengl_visual.h"
 #include "dsb_opengl_font.h"
+#include "dsb_visual_common.h"
 
 // Our SDL_Window (just like with SDL2 wihout OpenGL)
 static SDL_Window *g_mainWindow;
@@ -19,7 +25,41 @@ static SDL_Window *g_mainWindow;
 // Our opengl context handle
 static SDL_GLContext g_mainContext;
 
-static bool g_is_paused = false;
+// Steps published by the game (simulation) thread and played back by the render thread
+enum VisualEventType { VEV_FRAME, VEV_DELAY, VEV_TEXT };
+
+struct VisualEvent {
+	VisualEventType		type;
+	unsigned int		delay_factor;	// VEV_DELAY: amount of delay units to wait before the next event
+	std::string			text;			// VEV_TEXT: game log to print when playback reaches this point
+
+	// VEV_FRAME: snapshot of everything needed to draw the field
+	PlacementInfo		field;
+	DSBAlgoGenricData	gdata;
+	bool				is_combined;
+	bool				has_hints;
+	ShotHints			shot_hints;
+	bool				has_coords;
+	FieldCoords			coords;
+	ShotResult			sres;
+};
+
+// Each board (one in the normal view, grid_size^2 in the grid view) is fed by its own game thread
+struct BoardPlayback {
+	SpscQueue<VisualEvent, 128>	events;
+	VisualEvent					last_frame;		// kept to redraw the window on expose/resize
+	bool						has_frame;
+	Uint32						wait_until;		// playback of this board is delayed till this time
+
+	BoardPlayback()
+		: has_frame(false)
+		, wait_until(0)
+	{ }
+};
+
+static std::vector<std::unique_ptr<BoardPlayback>> g_boards;
+static unsigned int g_grid_size = 1;
+static std::atomic<bool> g_is_quit(false);	// playback is terminated by user, game threads should stop
 
 static void check_SDL_error(int line = -1)
 {
@@ -257,6 +297,9 @@ constexpr unsigned int g_default_window_height = 768;
 int g_cur_win_width = g_default_window_width;
 int g_cur_win_height = g_default_window_height;
 
+static float g_line_px = 2.5f;	// widths are lowered for small boards of the grid view
+static float g_point_px = 6.0f;
+
 void print_number_centered(float x, float y, unsigned int num)
 {
 	glColor3f(0.7, 1.0, 0.7);
@@ -270,8 +313,16 @@ void print_number_centered(float x, float y, unsigned int num)
 	dsb_opengl_print_string(s);
 }
 
-bool dsb_sdl_opengl_visual_init(const std::string &placement_name, const std::string &algo_name)
+bool dsb_sdl_opengl_visual_init(const std::string &placement_name, const std::string &algo_name, unsigned int grid_size /* = 1 */)
 {
+	g_grid_size = grid_size;
+	for (unsigned int i=0; i<grid_size*grid_size; ++i) {
+		g_boards.push_back(std::unique_ptr<BoardPlayback>(new BoardPlayback));
+	}
+	if (grid_size > 1) {
+		g_line_px = 1.0f;
+		g_point_px = 3.0f;
+	}
 
 	// Initialize SDL's Video subsystem
 	if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) < 0) {
@@ -282,6 +333,9 @@ bool dsb_sdl_opengl_visual_init(const std::string &placement_name, const std::st
 	std::string title("Deadly Sea Battle - AI competition: ");
 	title += placement_name + " placement, ";
 	title += algo_name + " algo";
+	if (grid_size > 1) {
+		title += ", " + std::to_string(grid_size) + "x" + std::to_string(grid_size) + " games";
+	}
 
 	// Create resizable centered window with pre-defined resolution
 	g_mainWindow = SDL_CreateWindow(title.c_str(), SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
@@ -345,258 +399,177 @@ bool dsb_sdl_opengl_visual_init(const std::string &placement_name, const std::st
 	return true;
 }
 
-bool dsb_sdl_opengl_visual_pause()
+// We assume that OpenGL viewport is -1.0f .. 1.0f for both GL x and y coords; each board is a square inside of it
+struct GLCoords {
+	float x;
+	float y;
+};
+
+struct GLColor {
+	float r;
+	float g;
+	float b;
+};
+
+// Location of the board in the window: top-left corner and size of one cell, in OpenGL coords
+struct BoardViewport {
+	GLCoords	corner;
+	float		cell;
+};
+
+inline GLCoords get_gl_coords_center(const BoardViewport& vp, unsigned int x, unsigned int y)
 {
-	SDL_Event event;
-	bool is_paused = true;
-	while (is_paused) {
-		while (SDL_PollEvent(&event)) {
-			if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_SPACE) {
-				is_paused = false;
-			} else if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_ESCAPE) {
-				return false;
-			} else if (event.type == SDL_QUIT) {
-				return false;
-			}
-		}
-		SDL_Delay(10);
-	}
-	return true;
+	GLCoords res;
+	res.x = vp.corner.x + (x+0.5f)*vp.cell;
+	res.y = vp.corner.y - (y+0.5f)*vp.cell;
+	return res;
 }
 
-bool dsb_sdl_opengl_visual_process_events()
+inline GLCoords get_gl_coords_top_left_corner(const BoardViewport& vp, unsigned int x, unsigned int y)
 {
-	SDL_Event event;
-	while (SDL_PollEvent(&event)) {
-		switch (event.type) {
-			case SDL_QUIT:
-				std::cout << "Asked to QUIT..." << std::endl;
-				return false;
-			case SDL_KEYDOWN:
-				switch (event.key.keysym.sym) {
-					case SDLK_ESCAPE:
-						std::cout << "Pressed Esc, QUITING..." << std::endl;
-						return false;
-					case SDLK_SPACE: {
-						std::cout << "Paused, press SPACE again to continue..." << std::endl;
-						if (!dsb_sdl_opengl_visual_pause()) {
-							return false;
-						}
-
-						break;
-					}
-					default:
-						break;
-				}
-				break;
-			case SDL_WINDOWEVENT: // update OpenGL after SDL window resize
-				if (event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED && event.window.windowID == SDL_GetWindowID(g_mainWindow)) {
-					glViewport(0, 0, event.window.data1, event.window.data2);
-					g_cur_win_width = event.window.data1;
-					g_cur_win_height = event.window.data2;
-				}
-				break;
-		}
-	}
-	return true;
+	GLCoords res;
+	res.x = vp.corner.x + x*vp.cell;
+	res.y = vp.corner.y - y*vp.cell;
+	return res;
 }
 
-// We assume that OpenGL viewport is -1.0f .. 1.0f for both GL x and y coords; size of field in OpenGL coords is 2.0f
-#define HFSF (FIELD_SIZE/2.0f)	// Half Field Size Float
-#define RHFSF (2.0f/FIELD_SIZE) // Reversed HFSF
-
-struct GLCoords {
+// All primitives of the frame (of all boards) are converted to triangles and collected here,
+// then the whole frame is drawn by single glDrawArrays() call
+struct GLVertex {
 	float x;
 	float y;
+	GLColor c;
 };
+static std::vector<GLVertex> g_batch;
 
-inline GLCoords get_gl_coords_center(unsigned int x, unsigned int y)
+static void batch_triangle(GLCoords a, GLCoords b, GLCoords c, GLColor color)
 {
-	GLCoords res;
-	res.x = (x-HFSF+0.5f)*RHFSF;
-	res.y = (HFSF-y-0.5f)*RHFSF;
-	return res;
+	GLVertex v[3] = { {a.x, a.y, color}, {b.x, b.y, color}, {c.x, c.y, color} };
+	g_batch.insert(g_batch.end(), v, v+3);
 }
 
-inline GLCoords get_gl_coords_top_left_corner(unsigned int x, unsigned int y)
+static void batch_rect(float x1, float y1, float x2, float y2, GLColor color)
 {
-	GLCoords res;
-	res.x = (x-HFSF)*RHFSF;
-	res.y = (HFSF-y)*RHFSF;
-	return res;
+	batch_triangle(GLCoords{x1, y1}, GLCoords{x1, y2}, GLCoords{x2, y2}, color);
+	batch_triangle(GLCoords{x1, y1}, GLCoords{x2, y2}, GLCoords{x2, y1}, color);
 }
 
-static void draw_bombed_square(unsigned int x, unsigned int y, int hint_color = -1)
+// Line of the given width (in pixels) as a thin quad; 1 pixel is 2.0f/window_size in GL coords
+static void batch_line(GLCoords a, GLCoords b, float width_px, GLColor color)
 {
+	float dx = b.x - a.x;
+	float dy = b.y - a.y;
+	float len = sqrtf(dx*dx + dy*dy);
+	if (len == 0.0f) return;
+
+	// normal vector of half-width length (pixels are converted to GL coords separately for x and y)
+	float nx = -dy/len * width_px / g_cur_win_width;
+	float ny = dx/len * width_px / g_cur_win_height;
+	GLCoords a1 = {a.x + nx, a.y + ny};
+	GLCoords a2 = {a.x - nx, a.y - ny};
+	GLCoords b1 = {b.x + nx, b.y + ny};
+	GLCoords b2 = {b.x - nx, b.y - ny};
+	batch_triangle(a1, a2, b2, color);
+	batch_triangle(a1, b2, b1, color);
+}
+
+static void batch_point(GLCoords c, float size_px, GLColor color)
+{
+	float dx = size_px / g_cur_win_width;
+	float dy = size_px / g_cur_win_height;
+	batch_rect(c.x-dx, c.y+dy, c.x+dx, c.y-dy, color);
+}
 
-	if (hint_color == -1) {
-		glBegin(GL_POLYGON);
-		glColor3f(1.0f, 0.8f, 0.8f);
-	} else if (hint_color >= 1 && hint_color <= 3) {
-		glBegin(GL_LINE_LOOP);
+static void draw_bombed_square(const BoardViewport& vp, unsigned int x, unsigned int y, int hint_color = -1)
+{
+	bool is_filled = true;
+	GLColor color = {1.0f, 0.8f, 0.8f};
+	if (hint_color >= 1 && hint_color <= 3) {
+		is_filled = false;
 		float c = (3-hint_color) * 0.25f + 0.3f;
-		glColor3f(c, c, 0.0f);
+		color = GLColor{c, c, 0.0f};
+	} else if (hint_color != -1) {
+		return;
 	}
- 
-	//const float radius = 0.1 * 0.5;
-	const float radius = (1.0f / FIELD_SIZE) * 0.7f;
-	GLCoords center = get_gl_coords_center(x, y);
+
+	const float radius = vp.cell * 0.35f;
+	GLCoords center = get_gl_coords_center(vp, x, y);
 
 	const int parts = 20;
-	for (int i=0; i<parts; i++) {
+	GLCoords prev = {center.x + radius, center.y};
+	for (int i=1; i<=parts; i++) {
 		float r = (i*M_PI*2) / parts;
-		glVertex2f(cosf(r)*radius + center.x, sinf(r)*radius + center.y);
+		GLCoords cur = {cosf(r)*radius + center.x, sinf(r)*radius + center.y};
+		if (is_filled) {
+			batch_triangle(center, prev, cur, color);
+		} else {
+			batch_line(prev, cur, g_line_px, color);
+		}
+		prev = cur;
 	}
-
-	glEnd();
 }
 
 enum SquareType {ST_HEALTH, ST_KILLED, ST_HARMED};
-static void draw_boat_square(unsigned int x, unsigned int y, SquareType st)
+static void draw_boat_square(const BoardViewport& vp, unsigned int x, unsigned int y, SquareType st)
 {
-
+	GLColor color = {0.1f, 0.25f, 0.1f};
 	switch (st) {
 		case ST_KILLED:
-			glColor3f(1.0f, 0.4f, 0.4f);
+			color = GLColor{1.0f, 0.4f, 0.4f};
 		break;
 		case ST_HARMED:
-			glColor3f(1.0f, 0.7f, 0.5f);
+			color = GLColor{1.0f, 0.7f, 0.5f};
 		break;
 		case ST_HEALTH:
-			glColor3f(0.1f, 0.25f, 0.1f);
 		break;
 	}
 
-	const float sz = RHFSF;
-	GLCoords corner = get_gl_coords_top_left_corner(x, y);
-
-	glBegin(GL_QUADS);
-		glVertex2f(corner.x, corner.y);
-		glVertex2f(corner.x, corner.y-sz);
-		glVertex2f(corner.x+sz, corner.y-sz);
-		glVertex2f(corner.x+sz, corner.y);
-	glEnd();
+	GLCoords corner = get_gl_coords_top_left_corner(vp, x, y);
+	batch_rect(corner.x, corner.y, corner.x+vp.cell, corner.y-vp.cell, color);
 }
 
-static void draw_miss_square(unsigned int x, unsigned int y, bool is_prohibited)
+static void draw_miss_square(const BoardViewport& vp, unsigned int x, unsigned int y, bool is_prohibited)
 {
-	GLCoords center = get_gl_coords_center(x, y);
+	GLCoords center = get_gl_coords_center(vp, x, y);
 
 	if (is_prohibited) {
-		const float d = (1.0f / FIELD_SIZE) * 0.3f;
-		glColor3f(1.0f, 1.0f, 1.0f);
-		glBegin(GL_LINES);
-			glVertex2f(center.x-d, center.y-d);
-			glVertex2f(center.x+d, center.y+d);
-			glVertex2f(center.x-d, center.y+d);
-			glVertex2f(center.x+d, center.y-d);
-		glEnd();
+		const float d = vp.cell * 0.15f;
+		GLColor white = {1.0f, 1.0f, 1.0f};
+		batch_line(GLCoords{center.x-d, center.y-d}, GLCoords{center.x+d, center.y+d}, g_line_px, white);
+		batch_line(GLCoords{center.x-d, center.y+d}, GLCoords{center.x+d, center.y-d}, g_line_px, white);
 	} else {
-		glPointSize(6.0f);
-		glColor3f(1.0f, 0.4f, 0.4f);
-
-		glBegin(GL_POINTS);
-			glVertex2f(center.x, center.y);
-		glEnd();
+		batch_point(center, g_point_px, GLColor{1.0f, 0.4f, 0.4f});
 	}
 }
 
-// Scans the field and check if harmed boat is only partially harmed or killed
-static bool
-check_if_boat_killed(const DSBAlgoGenricData& gdata, unsigned int x, unsigned int y)
-{
-	if (gdata._field.get(x, y) == FPI_KILLED) {
-		return true;
-	}
-
-	signed int sx = x;
-	signed int sy = y;
-
-#define CHECK_FOR_PART()							\
-	FieldPosInfo pi = gdata._field.get(sx, sy);		\
-	if (pi == FPI_KILLED) {							\
-		return true;								\
-	}												\
-	if (pi == FPI_MISSED || pi == FPI_UNKNOWN) {	\
-		break;										\
-	}
-
-	while (--sx >= 0) {
-		CHECK_FOR_PART()
-	}
-
-	sx = x;
-
-	while (++sx < FIELD_SIZE) {
-		CHECK_FOR_PART()
-	}
-
-	sx = x;
-
-
-	while (--sy >= 0) {
-		CHECK_FOR_PART()
-	}
-
-	sy = y;
-
-	while (++sy < FIELD_SIZE) {
-		CHECK_FOR_PART()
-	}
-
-	return false;
-}
-
-static bool
-check_if_near_killed_boat(const DSBAlgoGenricData& gdata, signed int x, signed int y)
-{
-	FieldPosInfo v;
-
-#define TEST_IF_KILLED_BOAT_CELL(X, Y)									\
-	v = gdata._field.get_or_bail(X, Y, FPI_UNKNOWN);					\
-	if (v == FPI_KILLED) {												\
-		return true;													\
-	} else if (v == FPI_HARMED && check_if_boat_killed(gdata, X, Y)) {	\
-		return true;													\
-	}
-
-	TEST_IF_KILLED_BOAT_CELL(x-1, y-1)
-	TEST_IF_KILLED_BOAT_CELL(x-1, y)
-	TEST_IF_KILLED_BOAT_CELL(x-1, y+1)
-	TEST_IF_KILLED_BOAT_CELL(x, y-1)
-	TEST_IF_KILLED_BOAT_CELL(x, y+1)
-	TEST_IF_KILLED_BOAT_CELL(x+1, y-1)
-	TEST_IF_KILLED_BOAT_CELL(x+1, y)
-	TEST_IF_KILLED_BOAT_CELL(x+1, y+1)
-
-	return false;
-}
+// Numbers can't be batched (raster font), they are collected to be printed after the batch
+struct HintNumber {
+	GLCoords		pos;
+	unsigned int	num;
+};
+static std::vector<HintNumber> g_hint_numbers;
 
-void dsb_sdl_opengl_visual_show_next_shot(const PlacementInfo& field,
+static void draw_board(const BoardViewport& vp, const PlacementInfo& field,
 	const DSBAlgoGenricData& gdata, bool is_combined, const ShotHints* shot_hints,
 	const FieldCoords* coords = NULL, ShotResult sres = SR_MISSED)
 {
+	const float size = vp.cell * FIELD_SIZE;
 	if (sres == SR_HARMED) {
-		glClearColor((random()*0.4f)/RAND_MAX, 0.0f, 0.0f, 1.0f);
+		// Own seed of the render thread: random() sequence belongs to the game thread
+		static unsigned int blink_seed = 0;
+		batch_rect(vp.corner.x, vp.corner.y, vp.corner.x+size, vp.corner.y-size,
+			GLColor{(rand_r(&blink_seed)*0.4f)/RAND_MAX, 0.0f, 0.0f});
 	} else if (sres == SR_KILLED) {
-		glClearColor(0.6f, 0.0f, 0.0f, 1.0f);
-	} else {
-		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+		batch_rect(vp.corner.x, vp.corner.y, vp.corner.x+size, vp.corner.y-size, GLColor{0.6f, 0.0f, 0.0f});
 	}
-	glClear(GL_COLOR_BUFFER_BIT);
 
 	// Draw a field FIELD_SIZE x FIELD_SIZE
-	glLineWidth(2.5f);
-	glColor3f(1.0f, 1.0f, 1.0f);
-	glBegin(GL_LINES);
-		for (signed int i=0;i <= FIELD_SIZE; i++) {
-			float f = (i-HFSF)*RHFSF;
-			glVertex2f(f, -1.0f);
-			glVertex2f(f, 1.0f);
-			glVertex2f(-1.0f, f);
-			glVertex2f(1.0f, f);
-		}
-	glEnd();
+	GLColor white = {1.0f, 1.0f, 1.0f};
+	for (signed int i=0;i <= FIELD_SIZE; i++) {
+		float f = i*vp.cell;
+		batch_line(GLCoords{vp.corner.x+f, vp.corner.y}, GLCoords{vp.corner.x+f, vp.corner.y-size}, g_line_px, white);
+		batch_line(GLCoords{vp.corner.x, vp.corner.y-f}, GLCoords{vp.corner.x+size, vp.corner.y-f}, g_line_px, white);
+	}
 
 	// Fill cells
 	for (signed int x=0; x<FIELD_SIZE; ++x) {
@@ -604,26 +577,26 @@ void dsb_sdl_opengl_visual_show_next_shot(const PlacementInfo& field,
 			bool is_ignore_hint = false;
 			if (coords != NULL && coords->_x == x && coords->_y == y) {
 				if (is_combined && field.get(x,y)) {
-					draw_boat_square(x, y, ST_HEALTH);
+					draw_boat_square(vp, x, y, ST_HEALTH);
 					is_ignore_hint = true;
 				}
-				draw_bombed_square(x, y);
+				draw_bombed_square(vp, x, y);
 			} else if (gdata._field.get(x, y) == FPI_UNKNOWN) {
 				if (field.get(x,y)) {
 					if (is_combined) {
-						draw_boat_square(x, y, ST_HEALTH);
+						draw_boat_square(vp, x, y, ST_HEALTH);
 					}
 				} else {
 					if (check_if_near_killed_boat(gdata, x,y)) {
-						draw_miss_square(x, y, /* is_prohibited = */ true);
+						draw_miss_square(vp, x, y, /* is_prohibited = */ true);
 						is_ignore_hint = true;
 					}
 				}
 			} else if (gdata._field.get(x, y) == FPI_MISSED) {
-				draw_miss_square(x, y, /* is_prohibited = */ false);
+				draw_miss_square(vp, x, y, /* is_prohibited = */ false);
 				is_ignore_hint = true;
 			} else {
-				draw_boat_square(x, y,
+				draw_boat_square(vp, x, y,
 					check_if_boat_killed(gdata, x,y) ? ST_KILLED : ST_HARMED
 				);
 				is_ignore_hint = true;
@@ -634,20 +607,263 @@ void dsb_sdl_opengl_visual_show_next_shot(const PlacementInfo& field,
 				auto hint_it = shot_hints->find(coord);
 				if (hint_it != shot_hints->end()) {
 					if (hint_it->second.hint_flags & SH_COLORED) {
-						draw_bombed_square(x, y, hint_it->second.hint_color);
+						draw_bombed_square(vp, x, y, hint_it->second.hint_color);
 					}
 
 					if (hint_it->second.hint_flags & SH_NUMBERED) {
-						GLCoords center = get_gl_coords_center(x, y);
-						print_number_centered(center.x, center.y, hint_it->second.hint_number);
+						HintNumber hn = { get_gl_coords_center(vp, x, y), (unsigned int) hint_it->second.hint_number };
+						g_hint_numbers.push_back(hn);
 					}
 				}
 			}
 		}
 	}
-	// print_number_centered(-0.9f, -0.9f, 12345678);
+}
+
+static void flush_batch()
+{
+	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+	glClear(GL_COLOR_BUFFER_BIT);
+
+	if (!g_batch.empty()) {
+		glEnableClientState(GL_VERTEX_ARRAY);
+		glEnableClientState(GL_COLOR_ARRAY);
+		glVertexPointer(2, GL_FLOAT, sizeof(GLVertex), &g_batch[0].x);
+		glColorPointer(3, GL_FLOAT, sizeof(GLVertex), &g_batch[0].c);
+		glDrawArrays(GL_TRIANGLES, 0, g_batch.size());
+		glDisableClientState(GL_COLOR_ARRAY);
+		glDisableClientState(GL_VERTEX_ARRAY);
+	}
+
+	for (auto& hn : g_hint_numbers) {
+		print_number_centered(hn.pos.x, hn.pos.y, hn.num);
+	}
 
 	SDL_GL_SwapWindow(g_mainWindow);
+
+	// keep allocated memory for the next frame
+	g_batch.clear();
+	g_hint_numbers.clear();
+}
+
+//----------------------------------------
+// Game thread side: events are queued without any waiting unless render thread is too far behind
+
+static bool publish(unsigned int board, VisualEvent&& ev)
+{
+	assert(board < g_boards.size());
+	while (!g_boards[board]->events.push(std::move(ev))) {
+		if (g_is_quit) {
+			return false;
+		}
+		// queue is full - playback is slower than the game, wait for render thread
+		// (game threads of the grid view sleep longer: there might be dozens of them)
+		SDL_Delay(g_grid_size > 1 ? 10 : 1);
+	}
+	return !g_is_quit;
+}
+
+bool dsb_sdl_opengl_visual_publish_frame(unsigned int board, const PlacementInfo& field,
+	const DSBAlgoGenricData& gdata, bool is_combined,
+	const ShotHints* shot_hints, const FieldCoords* coords /* = NULL */, ShotResult sres /* = SR_MISSED */)
+{
+	VisualEvent ev;
+	ev.type = VEV_FRAME;
+	ev.field = field;
+	ev.gdata = gdata;
+	ev.is_combined = is_combined;
+	ev.has_hints = (shot_hints != NULL);
+	if (shot_hints != NULL) {
+		ev.shot_hints = *shot_hints;
+	}
+	ev.has_coords = (coords != NULL);
+	if (coords != NULL) {
+		ev.coords = *coords;
+	}
+	ev.sres = sres;
+	return publish(board, std::move(ev));
+}
+
+bool dsb_sdl_opengl_visual_publish_delay(unsigned int board, unsigned int delay_factor)
+{
+	VisualEvent ev;
+	ev.type = VEV_DELAY;
+	ev.delay_factor = delay_factor;
+	return publish(board, std::move(ev));
+}
+
+bool dsb_sdl_opengl_visual_publish_text(unsigned int board, const std::string& text)
+{
+	if (g_grid_size > 1) {
+		return !g_is_quit; // logs of many games would be mixed, print nothing in the grid view
+	}
+	VisualEvent ev;
+	ev.type = VEV_TEXT;
+	ev.text = text;
+	return publish(board, std::move(ev));
+}
+
+bool dsb_sdl_opengl_visual_is_quit()
+{
+	return g_is_quit;
+}
+
+//----------------------------------------
+// Render thread side: playback of published events
+
+static void draw_all_boards()
+{
+	// Split the window into grid_size x grid_size squares with small gaps between boards
+	const float square = 2.0f / g_grid_size;
+	const float gap = (g_grid_size > 1) ? square * 0.04f : 0.0f;
+
+	for (unsigned int i=0; i<g_boards.size(); ++i) {
+		const BoardPlayback& b = *g_boards[i];
+		if (!b.has_frame) continue;
+
+		BoardViewport vp;
+		vp.corner.x = -1.0f + (i % g_grid_size) * square + gap/2;
+		vp.corner.y = 1.0f - (i / g_grid_size) * square - gap/2;
+		vp.cell = (square - gap) / FIELD_SIZE;
+
+		const VisualEvent& ev = b.last_frame;
+		const ShotHints* shot_hints = ev.has_hints ? &ev.shot_hints : NULL;
+		draw_board(vp, ev.field, ev.gdata, ev.is_combined, shot_hints, ev.has_coords ? &ev.coords : NULL, ev.sres);
+	}
+	if (g_grid_size > 1) {
+		g_hint_numbers.clear(); // Numbers are readable on the single board only
+	}
+	flush_batch();
+}
+
+// Handles user input; returns false if user asked to quit
+static bool process_playback_events(int timeout_ms, bool& is_paused, bool& is_step, float& speed, bool& is_redraw)
+{
+	SDL_Event event;
+	// Sleep until the next user event or until the next playback action is due
+	if (!SDL_WaitEventTimeout(&event, timeout_ms)) {
+		return true;
+	}
+	do {
+		switch (event.type) {
+			case SDL_QUIT:
+				std::cout << "Asked to QUIT..." << std::endl;
+				return false;
+			case SDL_KEYDOWN:
+				switch (event.key.keysym.sym) {
+					case SDLK_ESCAPE:
+						std::cout << "Pressed Esc, QUITING..." << std::endl;
+						return false;
+					case SDLK_SPACE:
+						is_paused = !is_paused;
+						if (is_paused) {
+							std::cout << "Paused, press SPACE again to continue or RIGHT to make a step..." << std::endl;
+						}
+						break;
+					case SDLK_RIGHT:
+						is_step = true;
+						break;
+					case SDLK_UP:
+					case SDLK_PLUS:
+					case SDLK_EQUALS:
+					case SDLK_KP_PLUS:
+						if (speed < 64.0f) speed *= 2.0f;
+						std::cout << "Playback speed x" << speed << std::endl;
+						break;
+					case SDLK_DOWN:
+					case SDLK_MINUS:
+					case SDLK_KP_MINUS:
+						if (speed > 1.0f/8) speed /= 2.0f;
+						std::cout << "Playback speed x" << speed << std::endl;
+						break;
+					default:
+						break;
+				}
+				break;
+			case SDL_WINDOWEVENT: // update OpenGL after SDL window resize
+				if (event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED && event.window.windowID == SDL_GetWindowID(g_mainWindow)) {
+					glViewport(0, 0, event.window.data1, event.window.data2);
+					g_cur_win_width = event.window.data1;
+					g_cur_win_height = event.window.data2;
+					is_redraw = true;
+				} else if (event.window.event == SDL_WINDOWEVENT_EXPOSED) {
+					is_redraw = true;
+				}
+				break;
+		}
+	} while (SDL_PollEvent(&event));
+	return true;
+}
+
+// Plays events of the board up to the next delay; returns true if a new frame is reached
+static bool play_board(BoardPlayback& b, Uint32 now, unsigned int delay_ms, float speed, bool is_key_pause, bool& is_paused)
+{
+	bool is_new_frame = false;
+	VisualEvent ev;
+	while (b.events.pop(ev)) {
+		if (ev.type == VEV_FRAME) {
+			std::swap(b.last_frame, ev);
+			b.has_frame = true;
+			is_new_frame = true;
+		} else if (ev.type == VEV_TEXT) {
+			std::cout << ev.text << std::flush;
+		} else {
+			if (is_key_pause) {
+				is_paused = true;
+			}
+			b.wait_until = now + (Uint32) (delay_ms * ev.delay_factor / speed);
+			break;
+		}
+	}
+	return is_new_frame;
+}
+
+bool dsb_sdl_opengl_visual_run(unsigned int delay_ms, bool is_key_pause, const std::atomic<unsigned int>& running_games)
+{
+	bool is_paused = false;		// SPACE: pause/resume playback
+	bool is_step = false;		// RIGHT: skip current delay (make a single step when paused)
+	bool is_redraw = false;
+	float speed = 1.0f;			// UP/DOWN (+/-): make playback faster/slower
+
+	for (;;) {
+		// Sleep till the closest delay of all boards is over (but check user input at least each 100ms)
+		Uint32 now = SDL_GetTicks();
+		signed int timeout = 100;
+		if (!is_paused) {
+			for (auto& b : g_boards) {
+				signed int left = (signed int)(b->wait_until - now);
+				if (left < timeout) timeout = (left > 0) ? left : 0;
+			}
+		}
+
+		if (!process_playback_events(timeout, is_paused, is_step, speed, is_redraw)) {
+			g_is_quit = true;
+			return false;
+		}
+
+		// Games are checked before their queues: events published by a game before it has finished are seen by the scan
+		const bool is_all_finished = (running_games.load(std::memory_order_acquire) == 0);
+
+		// Boards are played independently, the window is redrawn once when any of them has a new frame
+		now = SDL_GetTicks();
+		bool is_all_empty = true; // all events are played and all delays are over
+		for (auto& b : g_boards) {
+			if (is_step || (!is_paused && (signed int)(b->wait_until - now) <= 0)) {
+				is_redraw |= play_board(*b, now, delay_ms, speed, is_key_pause, is_paused);
+			}
+			is_all_empty &= (b->events.empty() && (signed int)(b->wait_until - now) <= 0);
+		}
+		is_step = false;
+
+		if (is_redraw) {
+			draw_all_boards(); // Swap is synchronized with vertical refresh so the redraw rate is limited by display
+			is_redraw = false;
+		}
+
+		if (is_all_empty && is_all_finished) {
+			return true;
+		}
+	}
 }
 
 void dsb_sdl_opengl_visual_cleanup()
@@ -1,15 +1,24 @@
 #ifndef _DSB_SDL_OPENGL_VISUAL_H__
 #define _DSB_SDL_OPENGL_VISUAL_H__
 
+#include <atomic>	// for std::atomic
+
 // SDL-OpenGL visal routines
-bool dsb_sdl_opengl_visual_init(const std::string &placement_name, const std::string &algo_name);
-bool dsb_sdl_opengl_visual_process_events();
+// Games run in separate threads and publish steps to the queue of their board (publish_* routines);
+// the thread which has made init() owns the window and plays published steps back via run().
+// Grid view shows grid_size x grid_size boards, each one is fed by its own game thread.
+bool dsb_sdl_opengl_visual_init(const std::string &placement_name, const std::string &algo_name, unsigned int grid_size = 1);
 
-void dsb_sdl_opengl_visual_show_next_shot(const PlacementInfo& field,
+// Game thread side; false is returned if user has terminated the playback
+bool dsb_sdl_opengl_visual_publish_frame(unsigned int board, const PlacementInfo& field,
 	const DSBAlgoGenricData& gdata, bool is_combined,
 	const ShotHints* shot_hints, const FieldCoords* coords = NULL, ShotResult sres = SR_MISSED);
+bool dsb_sdl_opengl_visual_publish_delay(unsigned int board, unsigned int delay_factor);
+bool dsb_sdl_opengl_visual_publish_text(unsigned int board, const std::string& text);
+bool dsb_sdl_opengl_visual_is_quit();
 
-bool dsb_sdl_opengl_visual_pause();
+// Render thread side; returns when all games are done and all steps are shown (true) or user has quit (false)
+bool dsb_sdl_opengl_visual_run(unsigned int delay_ms, bool is_key_pause, const std::atomic<unsigned int>& running_games);
 void dsb_sdl_opengl_visual_cleanup();
 
 #endif // _DSB_SDL_OPENGL_VISUAL_H__
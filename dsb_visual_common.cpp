@@ -0,0 +1,74 @@
+#include "common/all.h"
+#include "algo/api/dsb_algo_api.h"
+#include "dsb_visual_common.h"
+
+// Scans the field and check if harmed boat is only partially harmed or killed
+bool
+check_if_boat_killed(const DSBAlgoGenricData& gdata, unsigned int x, unsigned int y)
+{
+	if (gdata._field.get(x, y) == FPI_KILLED) {
+		return true;
+	}
+
+	signed int sx = x;
+	signed int sy = y;
+
+#define CHECK_FOR_PART()							\
+	FieldPosInfo pi = gdata._field.get(sx, sy);		\
+	if (pi == FPI_KILLED) {							\
+		return true;								\
+	}												\
+	if (pi == FPI_MISSED || pi == FPI_UNKNOWN) {	\
+		break;										\
+	}
+
+	while (--sx >= 0) {
+		CHECK_FOR_PART()
+	}
+
+	sx = x;
+
+	while (++sx < FIELD_SIZE) {
+		CHECK_FOR_PART()
+	}
+
+	sx = x;
+
+
+	while (--sy >= 0) {
+		CHECK_FOR_PART()
+	}
+
+	sy = y;
+
+	while (++sy < FIELD_SIZE) {
+		CHECK_FOR_PART()
+	}
+
+	return false;
+}
+
+bool
+check_if_near_killed_boat(const DSBAlgoGenricData& gdata, signed int x, signed int y)
+{
+	FieldPosInfo v;
+
+#define TEST_IF_KILLED_BOAT_CELL(X, Y)									\
+	v = gdata._field.get_or_bail(X, Y, FPI_UNKNOWN);					\
+	if (v == FPI_KILLED) {												\
+		return true;													\
+	} else if (v == FPI_HARMED && check_if_boat_killed(gdata, X, Y)) {	\
+		return true;													\
+	}
+
+	TEST_IF_KILLED_BOAT_CELL(x-1, y-1)
+	TEST_IF_KILLED_BOAT_CELL(x-1, y)
+	TEST_IF_KILLED_BOAT_CELL(x-1, y+1)
+	TEST_IF_KILLED_BOAT_CELL(x, y-1)
+	TEST_IF_KILLED_BOAT_CELL(x, y+1)
+	TEST_IF_KILLED_BOAT_CELL(x+1, y-1)
+	TEST_IF_KILLED_BOAT_CELL(x+1, y)
+	TEST_IF_KILLED_BOAT_CELL(x+1, y+1)
+
+	return false;
+}
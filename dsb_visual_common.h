@@ -0,0 +1,8 @@
+#ifndef __DSB_VISUAL_COMMON_H__
+#define __DSB_VISUAL_COMMON_H__
+
+// Field analysis routines shared by all graphical visuals
+bool check_if_boat_killed(const DSBAlgoGenricData& gdata, unsigned int x, unsigned int y);
+bool check_if_near_killed_boat(const DSBAlgoGenricData& gdata, signed int x, signed int y);
+
+#endif // __DSB_VISUAL_COMMON_H__
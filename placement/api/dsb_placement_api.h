@@ -3,6 +3,7 @@
 
 #include <string>			// for std::string
 #include <common/field.h>	// for PlacementInfo
+#include <common/fleet.h>	// for FleetInfo
 
 class DSBPlacementApi {
 public:
@@ -18,7 +19,8 @@ public:
 	}
 
 	virtual DSBPlacementApi* clone() const = 0;
-	virtual bool get_placement(PlacementInfo& field) = 0;
+	// Placement fills the field and describes each placed boat in the fleet
+	virtual bool get_placement(PlacementInfo& field, FleetInfo& fleet) = 0;
 	virtual ~DSBPlacementApi() {}
 };
 
@@ -1,11 +1,12 @@
 #include "eclipsed_placement.h"
 
-#include <deque>
 #include <utility>
 #include <limits>
 
 #include <common/coords.h>					// for FIELD_SIZE
 #include <common/field_bitmap.h>			// for FieldBitmap
+#include <common/eclipse_score.h>			// for get_eclipse_scores()
+#include <common/fixed_vector.h>			// for FixedVector
 #include <common/custom_params_parser.h>	// for CustomParamsParser
 
 constexpr PositionScore::value_type MAX_SCORE = std::numeric_limits<PositionScore::value_type>::max();
@@ -32,50 +33,38 @@ static void
 process_horizontal_boat(const FieldBitmap& eclipse, unsigned int size, PositionScore& score_map, bool is_transponated,
 	signed short& min_score, signed short& max_score)
 {
-	FieldRow boat_mask = FieldBitmap::get_boat_initial_mask(size);
-	FieldRow margin_mask = FieldBitmap::get_margin_initial_mask(size);
+	EclipseScores scores;
+	get_eclipse_scores(eclipse, /* denied_pos = */ eclipse, size, scores);
 
 	max_score = 0;
 	min_score = MAX_SCORE;
 
-	for (int x=0; x < FIELD_SIZE-size+1; x++) {
-		for (int y=0; y < FIELD_SIZE; y++) {
-			signed short score = -1;
-			if (!eclipse.is_intersected(y, boat_mask)) {
-				signed short score = static_cast<signed short>(eclipse.popcount3(y, margin_mask));
-				if (is_transponated) {
-					score_map._info[y][x] = score;
-				} else {
-					score_map._info[x][y] = score;
-				}
-				if (score > max_score) {
-					max_score = score;
-				}
-				if (score < min_score) {
-					min_score = score;
-				}
+	for (int y=0; y < FIELD_SIZE; y++) {
+		for (int x=0; x < FIELD_SIZE-size+1; x++) {
+			signed short score = scores._score[y][x];
+			if (score < 0) continue;
+
+			if (is_transponated) {
+				score_map.set(y, x, score);
 			} else {
-/*
-				if (is_transponated) {
-					score_map._info[y][x] = -1;
-				} else {
-					score_map._info[x][y] = -1;
-				}
-*/
+				score_map.set(x, y, score);
+			}
+			if (score > max_score) {
+				max_score = score;
+			}
+			if (score < min_score) {
+				min_score = score;
 			}
 		}
-
-		boat_mask = boat_mask << 1;
-		margin_mask = margin_mask << 1;
 	}
 
 #if 0 /* This step is not needed because we check out-of-bounds condition for placement outside */
 	for (int x=FIELD_SIZE-size+1; x<FIELD_SIZE; x++) {
 		for (int y=0; y < FIELD_SIZE; y++) {
 			if (is_transponated) {
-				score_map._info[y][x] = -1;
+				score_map.set(y, x, -1);
 			} else {
-				score_map._info[x][y] = -1;
+				score_map.set(x, y, -1);
 			}
 		}
 	}
@@ -83,7 +72,7 @@ process_horizontal_boat(const FieldBitmap& eclipse, unsigned int size, PositionS
 
 }
 
-bool EclipsedPlacement::put_boat(PlacementInfo& field, unsigned int size, bool is_max_eclipse /* = true */)
+bool EclipsedPlacement::put_boat(PlacementInfo& field, FleetInfo& fleet, unsigned int size, bool is_max_eclipse /* = true */)
 {
 	// Step 1 - process normal fields and horizontal boats
 	FieldBitmap eclipse;
@@ -93,8 +82,6 @@ bool EclipsedPlacement::put_boat(PlacementInfo& field, unsigned int size, bool i
 	//eclipse.dump();
 #endif
 
-	FieldBitmap field_bmp(field, /* is_transponate = */ false);
-
 	PositionScore score_map_h(-1);
 	signed short max_score_h;
 	signed short min_score_h;
@@ -106,7 +93,7 @@ bool EclipsedPlacement::put_boat(PlacementInfo& field, unsigned int size, bool i
 	score_map_h.dump();
 #endif
 
-	std::unique_ptr<PositionScore> pscore_map_v; // WIll be used only for case size>1
+	PositionScore score_map_v(-1); // WIll be used only for case size>1
 	signed short max_score_v = 0;
 
 	if (size > 1) {
@@ -116,17 +103,16 @@ bool EclipsedPlacement::put_boat(PlacementInfo& field, unsigned int size, bool i
 		eclipse_t.get_transponated(eclipse);
 
 		signed short dummy_min_score_v;
-		pscore_map_v.reset(new PositionScore(-1)); // Init by -1
-		process_horizontal_boat(eclipse_t, size, *pscore_map_v, /* is_transponated = */ true, dummy_min_score_v, max_score_v);
+		process_horizontal_boat(eclipse_t, size, score_map_v, /* is_transponated = */ true, dummy_min_score_v, max_score_v);
 
 #if DEBUG>1
 		std::cout << "Boat size = " << size << ", V score:\n";
-		pscore_map_v->dump();
+		score_map_v.dump();
 #endif
 	}
 
 	typedef std::pair<FieldCoords,bool> BoatPlacement; // coords of top-left corner and is_vertical can describe the position of the boat of known size
-	std::deque<BoatPlacement> best_eclipse;
+	FixedVector<BoatPlacement, FIELD_CELLS*2> best_eclipse; // horizontal and vertical placements of each cell
 
 	signed short max_score;
 	signed short score_tradeoff;
@@ -150,7 +136,7 @@ bool EclipsedPlacement::put_boat(PlacementInfo& field, unsigned int size, bool i
 				}
 
 				if (size > 1 && y<= FIELD_SIZE - size) {
-					if (pscore_map_v->get(coord) >= max_score-score_tradeoff) {
+					if (score_map_v.get(coord) >= max_score-score_tradeoff) {
 						best_eclipse.push_back(std::make_pair(coord, false));
 					}
 				}
@@ -183,6 +169,7 @@ bool EclipsedPlacement::put_boat(PlacementInfo& field, unsigned int size, bool i
 
 	CoordsSeq boat(/* coord= */ p.first, /* is_horizontal = */ p.second, size);
 	boat.mark_a_boat(field, true);
+	fleet.add_boat(p.first, p.second, size);
 
 	return true;
 }
@@ -193,7 +180,7 @@ bool EclipsedPlacement::put_boat(PlacementInfo& field, unsigned int size, bool i
 // To solve this issue, we can do the trick of placing 1-size boat in unexpected way (with minimal eclipse, in contrast to other boats with max eclipse).
 // The effect of uneclipsed placement is not so big but will force the opponent to scan many uneclipsed cells before the finial kill.
 
-bool EclipsedPlacement::get_placement(PlacementInfo& field)
+bool EclipsedPlacement::get_placement(PlacementInfo& field, FleetInfo& fleet)
 {
 	for (unsigned int size = 4; size > 0; --size) {
 		const int boats_count = 5 - size;
@@ -201,7 +188,7 @@ bool EclipsedPlacement::get_placement(PlacementInfo& field)
 			// Apply the trick for the last 1-size boat
 			bool is_min_eclipse = ((_min_eclipse_trick) && (size == 1) && (i == 3));
 			
-			if (!put_boat(field, size, /* is_max_eclipse = */ !is_min_eclipse)) {
+			if (!put_boat(field, fleet, size, /* is_max_eclipse = */ !is_min_eclipse)) {
 				return false;
 			}
 		}
@@ -32,10 +32,10 @@ public:
 	}
 
 	virtual bool process_custom_params(const std::string& params);
-	virtual bool get_placement(PlacementInfo& field);
+	virtual bool get_placement(PlacementInfo& field, FleetInfo& fleet);
 
 private:
-	bool put_boat(PlacementInfo& field, unsigned int size, bool is_max_eclipse = true);
+	bool put_boat(PlacementInfo& field, FleetInfo& fleet, unsigned int size, bool is_max_eclipse = true);
 
 	unsigned short	_max_eclipse_tradeoff;
 	bool			_min_eclipse_trick;
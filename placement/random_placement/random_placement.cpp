@@ -13,13 +13,13 @@ bool RandomPlacement::is_placement_available(const PlacementInfo& field, const C
 
 	for (unsigned int xp = c1._x; xp <= c2._x; ++xp) {
 		for (unsigned int yp = c1._y; yp <= c2._y; ++yp) {
-			if (field._info[xp][yp]) return false;
+			if (field.get(xp, yp)) return false;
 		}
 	}
 	return true;
 }
 
-bool RandomPlacement::put_boat(PlacementInfo& field, unsigned int size)
+bool RandomPlacement::put_boat(PlacementInfo& field, FleetInfo& fleet, unsigned int size)
 {
 	const unsigned int max_tries = 1000;
 	for (unsigned int tries = 0; tries < max_tries; ++tries) {	
@@ -44,6 +44,7 @@ bool RandomPlacement::put_boat(PlacementInfo& field, unsigned int size)
 		if (!is_placement_available(field, boat)) continue;
 
 		boat.mark_a_boat(field, true);
+		fleet.add_boat(head, is_x_seq, size);
 
 		return true;
 	}
@@ -52,13 +53,13 @@ bool RandomPlacement::put_boat(PlacementInfo& field, unsigned int size)
 	return false;
 }
 
-bool RandomPlacement::get_placement(PlacementInfo& field)
+bool RandomPlacement::get_placement(PlacementInfo& field, FleetInfo& fleet)
 {
 
 	for (unsigned int size = 4; size > 0; --size) {
 		const int boats_count = 5 - size;
 		for (int i = 0; i<boats_count; ++i) {
-			if (!put_boat(field, size)) {
+			if (!put_boat(field, fleet, size)) {
 				return false;
 			}
 		}
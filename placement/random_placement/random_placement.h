@@ -18,9 +18,9 @@ public:
 		return new RandomPlacement();
 	}
 		
-	virtual bool get_placement(PlacementInfo& field);
+	virtual bool get_placement(PlacementInfo& field, FleetInfo& fleet);
 private:
-	bool put_boat(PlacementInfo& field, unsigned int size);
+	bool put_boat(PlacementInfo& field, FleetInfo& fleet, unsigned int size);
 	bool is_placement_available(const PlacementInfo& field, const CoordsSeq& boat) const;
 };
 